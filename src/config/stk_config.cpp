@@ -161,6 +161,7 @@ void STKConfig::load(const std::string &filename)
     CHECK_NEG(m_network_steering_reduction,"network steering-reduction" );
     CHECK_NEG(m_default_moveable_friction, "physics default-moveable-friction");
     CHECK_NEG(m_solver_iterations,         "physics: solver-iterations"       );
+    CHECK_NEG(m_broadphase_margin,         "physics: broadphase-margin"       );
     CHECK_NEG(m_solver_split_impulse_thresh,"physics: solver-split-impulse-threshold");
     CHECK_NEG(m_snb_min_adjust_length, "network smoothing: min-adjust-length");
     CHECK_NEG(m_snb_max_adjust_length, "network smoothing: max-adjust-length");
@@ -213,6 +214,8 @@ void STKConfig::init_defaults()
     m_solver_iterations          = -100;
     m_solver_set_flags           = 0;
     m_solver_reset_flags         = 0;
+    m_broadphase                 = "axis-sweep";
+    m_broadphase_margin          = -100.0f;
     m_network_steering_reduction = -100;
     m_title_music                = NULL;
     m_default_music              = NULL;
@@ -325,6 +328,8 @@ void STKConfig::getAllData(const XMLNode * root)
         physics_node->get("solver-split-impulse",   &m_solver_split_impulse  );
         physics_node->get("solver-split-impulse-threshold",
                                                &m_solver_split_impulse_thresh);
+        physics_node->get("broadphase",             &m_broadphase            );
+        physics_node->get("broadphase-margin",      &m_broadphase_margin     );
         std::vector<std::string> solver_modes;
         physics_node->get("solver-mode",            &solver_modes            );
         m_solver_set_flags=0, m_solver_reset_flags = 0;
@@ -122,6 +122,14 @@ public:
      *  added to the solver mode, bits set in reset_flags are removed. */
     int m_solver_set_flags, m_solver_reset_flags;
 
+    /** Default bullet broadphase: "axis-sweep", "axis-sweep-32" or
+     *  "dbvt". Can be changed per track. */
+    std::string m_broadphase;
+
+    /** Distance added on each side of the track bounding box to get the
+     *  world bounds of the broadphase. */
+    float m_broadphase_margin;
+
     int   m_max_skidmarks;           /**<Maximum number of skid marks/kart.  */
     float m_skid_fadeout_time;       /**<Time till skidmarks fade away.      */
     float m_near_ground;             /**<Determines when a kart is not near
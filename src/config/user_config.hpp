@@ -745,6 +745,15 @@ namespace UserConfigParams
     /** True if physics debugging should be enabled. */
     PARAM_PREFIX bool m_physics_debug PARAM_DEFAULT( false );
 
+    /** If not empty, the broadphase to use for all tracks (used to compare
+     *  the performance of the broadphases). */
+    PARAM_PREFIX std::string m_broadphase PARAM_DEFAULT( "" );
+
+    /** True if rewinds and a server catching up should replay ticks with
+     *  the full world update instead of simulation-only ticks (used to
+     *  compare the performance of both). */
+    PARAM_PREFIX bool m_full_tick_replay PARAM_DEFAULT( false );
+
     /** True if fps should be printed each frame. */
     PARAM_PREFIX bool m_fps_debug PARAM_DEFAULT(false);
 
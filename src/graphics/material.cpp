@@ -387,6 +387,24 @@ Material::Material(const XMLNode *node, bool deprecated)
         m_high_tire_adhesion = true;
 }   // Material
 
+//-----------------------------------------------------------------------------
+/** Returns the gameplay relevant properties of this material as a
+ *  combination of TerrainFlags.
+ */
+uint16_t Material::getTerrainFlags() const
+{
+    uint16_t flags = 0;
+    if (m_zipper)             flags |= TF_ZIPPER;
+    if (m_drive_reset)        flags |= TF_DRIVE_RESET;
+    if (m_has_gravity)        flags |= TF_GRAVITY;
+    if (m_high_tire_adhesion) flags |= TF_HIGH_ADHESION;
+    if (m_below_surface)      flags |= TF_BELOW_SURFACE;
+    if (m_surface)            flags |= TF_SURFACE;
+    if (m_falling_effect)     flags |= TF_FALLING_EFFECT;
+    if (m_is_jump_texture)    flags |= TF_JUMP;
+    return flags;
+}   // getTerrainFlags
+
 //-----------------------------------------------------------------------------
 video::ITexture* Material::getTexture(bool srgb, bool premul_alpha)
 {
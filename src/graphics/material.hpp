@@ -22,6 +22,7 @@
 
 #include "utils/no_copy.hpp"
 #include "utils/random_generator.hpp"
+#include "utils/types.hpp"
 
 #include <array>
 #include <assert.h>
@@ -62,6 +63,21 @@ public:
         PUSH_SOCCER_BALL
     };
 
+    /** Gameplay relevant properties as bit flags. They are stored for each
+     *  triangle of a TriangleMesh, so the terrain tests done for each kart
+     *  in each tick don't need to read the material. */
+    enum TerrainFlags
+    {
+        TF_ZIPPER         = 1 << 0,
+        TF_DRIVE_RESET    = 1 << 1,
+        TF_GRAVITY        = 1 << 2,
+        TF_HIGH_ADHESION  = 1 << 3,
+        TF_BELOW_SURFACE  = 1 << 4,
+        TF_SURFACE        = 1 << 5,
+        TF_FALLING_EFFECT = 1 << 6,
+        TF_JUMP           = 1 << 7
+    };
+
 private:
 
     /** Pointer to the texture. */
@@ -232,6 +248,8 @@ public:
     // ------------------------------------------------------------------------
     bool  isIgnore           () const { return m_ignore;             }
     // ------------------------------------------------------------------------
+    uint16_t getTerrainFlags() const;
+    // ------------------------------------------------------------------------
     /** Returns true if this material is a zipper. */
     bool  isZipper           () const { return m_zipper;             }
     // ------------------------------------------------------------------------
@@ -254,6 +254,7 @@ FileManager::FileManager()
     checkAndCreateScreenshotDir();
     checkAndCreateReplayDir();
     checkAndCreateCachedTexturesDir();
+    checkAndCreateCachedDataDir();
     checkAndCreateGPDir();
 
     redirectOutput();
@@ -839,6 +840,14 @@ std::string FileManager::getCachedTexturesDir() const
     return m_cached_textures_dir;
 }   // getCachedTexturesDir
 
+//-----------------------------------------------------------------------------
+/** Returns the directory in which data computed from tracks is cached.
+ */
+std::string FileManager::getCachedDataDir() const
+{
+    return m_cached_data_dir;
+}   // getCachedDataDir
+
 //-----------------------------------------------------------------------------
 /** Returns the directory in which user-defined grand prix should be stored.
  */
@@ -1181,6 +1190,31 @@ void FileManager::checkAndCreateCachedTexturesDir()
 
 }   // checkAndCreateCachedTexturesDir
 
+// ----------------------------------------------------------------------------
+/** Creates the directories for cached data. This will set
+*  m_cached_data_dir with the appropriate path.
+*/
+void FileManager::checkAndCreateCachedDataDir()
+{
+#if defined(WIN32)
+    m_cached_data_dir = m_user_config_dir + "cached-data/";
+#elif defined(__APPLE__)
+    m_cached_data_dir = getenv("HOME");
+    m_cached_data_dir += "/Library/Application Support/SuperTuxKart/CachedData/";
+#else
+    m_cached_data_dir = checkAndCreateLinuxDir("XDG_CACHE_HOME", "supertuxkart", ".cache/", ".");
+    m_cached_data_dir += "cached-data/";
+#endif
+
+    if (!checkAndCreateDirectory(m_cached_data_dir))
+    {
+        Log::error("FileManager", "Can not create cached data directory '%s', "
+            "falling back to '.'.", m_cached_data_dir.c_str());
+        m_cached_data_dir = ".";
+    }
+
+}   // checkAndCreateCachedDataDir
+
 // ----------------------------------------------------------------------------
 /** Creates the directories for user-defined grand prix. This will set m_gp_dir
  *  with the appropriate path.
@@ -1504,6 +1538,34 @@ bool FileManager::removeFile(const std::string &name) const
     return false;
 }   // removeFile
 
+// ----------------------------------------------------------------------------
+/** Removes cached data saved for an older version of the same source, so each
+ *  change of e.g. a track doesn't leave another file in the cache directory.
+ *  Cache files are named <type>-<source hash>-<content hash>.<extension>, so
+ *  all other files with the same name up to the last '-' and the same
+ *  extension are removed.
+ *  \param file Full path of the cache file which was just saved.
+ */
+void FileManager::removeOutdatedCachedData(const std::string &file) const
+{
+    const std::string dir = StringUtils::getPath(file);
+    const std::string name = StringUtils::getBasename(file);
+    const std::string prefix = name.substr(0, name.rfind('-') + 1);
+    const std::string suffix = "." + StringUtils::getExtension(name);
+    std::set<std::string> files;
+    listFiles(files, dir);
+    for (const std::string& f : files)
+    {
+        if (f != name && StringUtils::startsWith(f, prefix) &&
+            StringUtils::hasSuffix(f, suffix))
+        {
+            Log::info("FileManager", "Removing outdated cache file '%s'.",
+                      f.c_str());
+            removeFile(dir + "/" + f);
+        }
+    }
+}   // removeOutdatedCachedData
+
 // ----------------------------------------------------------------------------
 /** Removes a directory (including all files contained). The function could
  *  easily recursively delete further subdirectories, but this is commented
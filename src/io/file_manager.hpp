@@ -98,6 +98,10 @@ private:
     /** Directory where resized textures are cached. */
     std::string       m_cached_textures_dir;
 
+    /** Directory where data computed from tracks (e.g. collision trees) is
+     *  cached. */
+    std::string       m_cached_data_dir;
+
     /** Directory where user-defined grand prix are stored. */
     std::string       m_gp_dir;
 
@@ -128,6 +132,7 @@ private:
     void              checkAndCreateScreenshotDir();
     void              checkAndCreateReplayDir();
     void              checkAndCreateCachedTexturesDir();
+    void              checkAndCreateCachedDataDir();
     void              checkAndCreateGPDir();
     void              discoverPaths();
     void              addAssetsSearchPath();
@@ -154,6 +159,7 @@ public:
     std::string       getScreenshotDir() const;
     std::string       getReplayDir() const;
     std::string       getCachedTexturesDir() const;
+    std::string       getCachedDataDir() const;
     std::string       getGPDir() const;
     bool              checkAndCreateDirectory(const std::string &path);
     bool              checkAndCreateDirectoryP(const std::string &path);
@@ -163,6 +169,7 @@ public:
     bool isDirectory(const std::string &path) const;
     bool removeFile(const std::string &name) const;
     bool removeDirectory(const std::string &name) const;
+    void removeOutdatedCachedData(const std::string &file) const;
     // ------------------------------------------------------------------------
     bool moveDirectoryInto(std::string source, std::string target);
     // ------------------------------------------------------------------------
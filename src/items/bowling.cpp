@@ -109,8 +109,7 @@ bool Bowling::updateAndDelete(int ticks)
     float hat = (getXYZ() - getHitPoint()).length();
     if(hat-0.5f*m_extend.getY()<0.01f)
     {
-        const Material *material = getMaterial();
-        if(!material || material->isDriveReset())
+        if (!getMaterial() || hasTerrainFlag(Material::TF_DRIVE_RESET))
         {
             hit(NULL);
             removeRollSfx();
@@ -59,6 +59,7 @@ float         Flyable::m_st_min_height  [PowerupManager::POWERUP_MAX];
 float         Flyable::m_st_max_height  [PowerupManager::POWERUP_MAX];
 float         Flyable::m_st_force_updown[PowerupManager::POWERUP_MAX];
 Vec3          Flyable::m_st_extend      [PowerupManager::POWERUP_MAX];
+bool          Flyable::m_st_ccd         [PowerupManager::POWERUP_MAX];
 // ----------------------------------------------------------------------------
 
 Flyable::Flyable(AbstractKart *kart, PowerupManager::PowerupType type,
@@ -157,6 +158,7 @@ void Flyable::createPhysics(float forw_offset, const Vec3 &velocity,
     createBody(m_mass, trans, m_shape, restitution);
     m_user_pointer.set(this);
     Physics::get()->addBody(getBody());
+    m_previous_xyz = trans.getOrigin();
 
     m_body->setGravity(gravity);
     if (gravity.length2() != 0.0f && m_do_terrain_info)
@@ -203,10 +205,12 @@ void Flyable::init(const XMLNode &node, scene::IMesh *model,
     m_st_max_height[type]   = 1.0f;
     m_st_min_height[type]   = 3.0f;
     m_st_force_updown[type] = 15.0f;
+    m_st_ccd[type]          = false;
     node.get("speed",           &(m_st_speed[type])       );
     node.get("min-height",      &(m_st_min_height[type])  );
     node.get("max-height",      &(m_st_max_height[type])  );
     node.get("force-updown",    &(m_st_force_updown[type]));
+    node.get("ccd",             &(m_st_ccd[type])         );
 
     // Store the size of the model
     Vec3 min, max;
@@ -261,6 +265,9 @@ void Flyable::getClosestKart(const AbstractKart **minKart,
     *minKart = NULL;
 
     World *world = World::getWorld();
+    const bool has_team = world->hasTeam();
+    const KartTeam owner_team =
+        has_team ? world->getKartTeam(m_owner->getWorldKartId()) : KART_TEAM_NONE;
     for(unsigned int i=0 ; i<world->getNumKarts(); i++ )
     {
         AbstractKart *kart = world->getKart(i);
@@ -271,9 +278,8 @@ void Flyable::getClosestKart(const AbstractKart **minKart,
             kart->getKartAnimation()                   ) continue;
 
         // Don't hit teammates in team world
-        if (world->hasTeam() &&
-            world->getKartTeam(kart->getWorldKartId()) ==
-            world->getKartTeam(m_owner->getWorldKartId()))
+        if (has_team &&
+            world->getKartTeam(kart->getWorldKartId()) == owner_team)
             continue;
 
         btTransform t=kart->getTrans();
@@ -419,6 +425,108 @@ void Flyable::updateGraphics(float dt)
     Moveable::updateGraphics();
 }   // updateGraphics
 
+//-----------------------------------------------------------------------------
+namespace
+{
+    /** Sweep callback that only reports the track. Flyables have no contact
+     *  response, so the default callback (which tests needsResponse) can't
+     *  be used. */
+    class TrackSweepCallback : public btCollisionWorld::ClosestConvexResultCallback
+    {
+    public:
+        TrackSweepCallback(const btVector3 &from, const btVector3 &to)
+            : btCollisionWorld::ClosestConvexResultCallback(from, to) {}
+        // --------------------------------------------------------------------
+        virtual bool needsCollision(btBroadphaseProxy* proxy) const
+        {
+            const btCollisionObject *obj =
+                (const btCollisionObject*)proxy->m_clientObject;
+            const UserPointer *up = (UserPointer*)obj->getUserPointer();
+            return up && up->is(UserPointer::UP_TRACK);
+        }   // needsCollision
+    };   // TrackSweepCallback
+}   // anonymous namespace
+
+//-----------------------------------------------------------------------------
+/** Sweeps a sphere from one position to another and tests if it touches
+ *  the track on its way.
+ *  \param world The collision world containing the track.
+ *  \param from Start position of the sweep.
+ *  \param to End position of the sweep.
+ *  \param radius Radius of the swept sphere.
+ *  \param hit_xyz On return the center of the sphere at the first contact.
+ *  \return True if the track was hit.
+ */
+bool Flyable::sweepTrack(const btCollisionWorld *world, const Vec3 &from,
+                         const Vec3 &to, float radius, Vec3 *hit_xyz)
+{
+    if ((to - from).length2() < 0.0001f)
+        return false;
+    btSphereShape sphere(radius);
+    btTransform start(btQuaternion(0, 0, 0, 1), from);
+    btTransform end(btQuaternion(0, 0, 0, 1), to);
+    TrackSweepCallback callback(from, to);
+    world->convexSweepTest(&sphere, start, end, callback);
+    if (!callback.hasHit())
+        return false;
+    hit_xyz->setInterpolate3(from, to, callback.m_closestHitFraction);
+    return true;
+}   // sweepTrack
+
+// ----------------------------------------------------------------------------
+/** Fires a fast flyable through a thin wall and makes sure the sweep
+ *  detects the wall, even though neither end position touches it.
+ */
+void Flyable::unitTesting()
+{
+    btDefaultCollisionConfiguration config;
+    btCollisionDispatcher dispatcher(&config);
+    btDbvtBroadphase broadphase;
+    btCollisionWorld world(&dispatcher, &broadphase, &config);
+
+    // A 10 cm thick wall at x=0
+    btBoxShape wall_shape(btVector3(0.05f, 5.0f, 5.0f));
+    btCollisionObject wall;
+    wall.setCollisionShape(&wall_shape);
+    UserPointer up;
+    up.set((TriangleMesh*)NULL);
+    wall.setUserPointer(&up);
+    world.addCollisionObject(&wall);
+
+    // A cake with speed 50 covers about 0.4 m per physics step at 120 Hz,
+    // use an even larger step to make sure it ends up behind the wall.
+    Vec3 from(-1.0f, 0, 0), to(1.0f, 0, 0);
+    const float radius = 0.1f;
+    Vec3 hit_xyz;
+    if (!sweepTrack(&world, from, to, radius, &hit_xyz))
+        Log::error("Flyable", "Sweep through the wall was not detected.");
+    else if (hit_xyz.getX() > -0.05f || hit_xyz.getX() < -0.2f)
+    {
+        Log::error("Flyable", "Wrong sweep hit position %f.",
+                   hit_xyz.getX());
+    }
+
+    // Short moves around either end position don't touch the wall
+    const Vec3 step(0.1f, 0, 0);
+    if (sweepTrack(&world, from, from + step, radius, &hit_xyz) ||
+        sweepTrack(&world, to, to + step, radius, &hit_xyz))
+        Log::error("Flyable", "Sweep hit the wall away from it.");
+
+    // A flyable passing next to the wall is not stopped
+    if (sweepTrack(&world, Vec3(-1.0f, 6.0f, 0), Vec3(1.0f, 6.0f, 0),
+                   radius, &hit_xyz))
+        Log::error("Flyable", "Sweep next to the wall hit it.");
+
+    // Non-track objects (e.g. karts) are ignored
+    UserPointer kart_up;
+    kart_up.set((AbstractKart*)NULL);
+    wall.setUserPointer(&kart_up);
+    if (sweepTrack(&world, from, to, radius, &hit_xyz))
+        Log::error("Flyable", "Sweep hit a non-track object.");
+
+    world.removeCollisionObject(&wall);
+}   // unitTesting
+
 //-----------------------------------------------------------------------------
 /** Updates this flyable. It calls Moveable::update. If this function returns
  *  true, the flyable will be deleted by the projectile manager.
@@ -437,6 +545,8 @@ bool Flyable::updateAndDelete(int ticks)
         // Move the physical body to infinity so it doesn't interact with
         // game objects (for easier rewind)
         moveToInfinity(/*set_moveable_trans*/false);
+        // The body is put back at the animated position afterwards
+        m_previous_xyz = getXYZ();
         return false;
     }   // if animation
 
@@ -479,6 +589,27 @@ bool Flyable::updateAndDelete(int ticks)
         return true;
     }
 
+    // Bullet only detects collisions at the end of a physics step, so a fast
+    // flyable can end up behind a thin wall without ever touching it. Sweep
+    // a sphere from the position of the previous update to catch such hits.
+    // The body has no contact response, so bullet's own CCD would not do
+    // this.
+    float size = std::min(m_extend.getX(),
+                          std::min(m_extend.getY(), m_extend.getZ()));
+    if (m_st_ccd[m_type] && m_mass != 0.0f && size > 0.0f)
+    {
+        Vec3 hit_xyz;
+        if (sweepTrack(Physics::get()->getPhysicsWorld(), m_previous_xyz, xyz,
+                       0.4f * size, &hit_xyz))
+        {
+            setXYZ(hit_xyz);
+            hitTrack();
+            if (m_has_hit_something)
+                return true;
+        }
+    }
+    m_previous_xyz = xyz;
+
     if (m_do_terrain_info)
     {
         Vec3 towards = MiniGLM::decompressVector3(m_compressed_gravity_vector);
@@ -490,8 +621,7 @@ bool Flyable::updateAndDelete(int ticks)
         TerrainInfo::update(xyz + m_position_offset*(-towards), towards);
 
         // Make flyable anti-gravity when the it's projected on such surface
-        const Material* m = TerrainInfo::getMaterial();
-        if (m && m->hasGravity())
+        if (TerrainInfo::hasTerrainFlag(Material::TF_GRAVITY))
         {
             getBody()->setGravity(TerrainInfo::getNormal() * -70.0f);
         }
@@ -723,6 +853,9 @@ void Flyable::restoreState(BareNetworkString *buffer, int count)
             buffer, m_body.get(), m_motion_state.get());
         m_transform = m_body->getWorldTransform();
     }
+    // The position before the restored state is unknown, so don't sweep
+    // in the next update
+    m_previous_xyz = m_body->getWorldTransform().getOrigin();
     m_ticks_since_thrown = ticks_since_thrown_animation & 32767;
     m_has_server_state = true;
     m_has_hit_something = false;
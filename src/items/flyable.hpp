@@ -39,6 +39,7 @@ class AbstractKart;
 class AbstractKartAnimation;
 class HitEffect;
 class PhysicalObject;
+class btCollisionWorld;
 class XMLNode;
 
 /**
@@ -68,6 +69,11 @@ private:
      *  set this to false with a call do setDoTerrainInfo(). */
     bool              m_do_terrain_info;
 
+    /** Position of the flyable in the previous update, i.e. before the
+     *  last physics step. Start of the sweep when checking for hits with
+     *  the track. */
+    Vec3              m_previous_xyz;
+
     /* Used in network to restore previous gravity in compressed form. */
     uint32_t          m_compressed_gravity_vector;
 
@@ -152,6 +158,11 @@ protected:
     /** Size of the model. */
     static Vec3       m_st_extend[PowerupManager::POWERUP_MAX];
 
+    /** True if the motion in one physics step should be tested against
+     *  the track with a swept sphere, so fast flyables can't tunnel
+     *  through thin walls. */
+    static bool       m_st_ccd[PowerupManager::POWERUP_MAX];
+
     /** Set to something > -1 if this flyable should auto-destrcut after
      *  that may ticks. */
     int               m_max_lifespan;
@@ -184,6 +195,9 @@ protected:
 
     void              moveToInfinity(bool set_moveable_trans = true);
     void              removePhysics();
+    static bool       sweepTrack(const btCollisionWorld *world,
+                                 const Vec3 &from, const Vec3 &to,
+                                 float radius, Vec3 *hit_xyz);
 public:
 
                  Flyable     (AbstractKart* kart,
@@ -192,6 +206,7 @@ public:
     virtual     ~Flyable     ();
     static void  init        (const XMLNode &node, scene::IMesh *model,
                               PowerupManager::PowerupType type);
+    static void  unitTesting ();
     void                      updateGraphics(float dt) OVERRIDE;
     virtual bool              updateAndDelete(int ticks);
     virtual void              setAnimation(AbstractKartAnimation *animation);
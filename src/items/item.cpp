@@ -49,6 +49,8 @@
 ItemState::ItemState(ItemType type, const AbstractKart *owner, int id)
 {
     setType(type);
+    m_original_type = ITEM_NONE;
+    m_ticks_till_return = 0;
     m_item_id = id;
     m_previous_owner = owner;
     m_used_up_counter = -1;
@@ -400,6 +400,11 @@ public:
         return lc.length2() < m_distance_2;
     }   // hitKart
     // ------------------------------------------------------------------------
+    /** Returns the maximum horizontal distance at which a kart can hit this
+     *  item. Since hitKart halves the height in the local coordinates of the
+     *  item, this is twice the collection distance. */
+    float getHitRadius() const             { return 2.0f * sqrtf(m_distance_2); }
+    // ------------------------------------------------------------------------
     bool rotating() const               { return getType() != ITEM_BUBBLEGUM; }
 
 public:
@@ -39,6 +39,8 @@
 #include <IAnimatedMesh.h>
 
 #include <assert.h>
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <sstream>
 #include <string>
@@ -148,6 +150,9 @@ void ItemManager::removeTextures()
 ItemManager::ItemManager()
 {
     m_switch_ticks = -1;
+    m_item_grid_cell_size  = 1.0f;
+    m_item_grid_hit_radius = 0.0f;
+    m_item_grid_dirty      = true;
     // The actual loading is done in loadDefaultItems
 
     // Prepare the switch to array, which stores which item should be
@@ -234,6 +239,7 @@ unsigned int ItemManager::insertItem(Item *item)
  */
 void ItemManager::insertItemInQuad(Item *item)
 {
+    m_item_grid_dirty = true;
     if(m_items_in_quads)
     {
         int graph_node = item->getGraphNode();
@@ -356,38 +362,94 @@ void ItemManager::collectedItem(ItemState *item, AbstractKart *kart)
     kart->collectedItem(item);
 }   // collectedItem
 
+//-----------------------------------------------------------------------------
+/** Builds the grid used by checkItemHit from the current positions of all
+ *  items. Each item is stored in the cell containing its position.
+ */
+void ItemManager::buildItemGrid()
+{
+    m_item_grid.clear();
+    m_item_grid_hit_radius = 0.0f;
+    for (ItemState* is : m_all_items)
+    {
+        const Item* item = dynamic_cast<Item*>(is);
+        if (item)
+        {
+            m_item_grid_hit_radius = std::max(m_item_grid_hit_radius,
+                                              item->getHitRadius());
+        }
+    }
+    // Add a small margin, so rounding errors in hitKart can't make a
+    // difference
+    m_item_grid_hit_radius += 0.1f;
+    m_item_grid_cell_size = 2.0f * m_item_grid_hit_radius;
+
+    for (unsigned int i = 0; i < m_all_items.size(); i++)
+    {
+        if (!m_all_items[i])
+            continue;
+        const Vec3& xyz = m_all_items[i]->getXYZ();
+        const int x = (int)floorf(xyz.getX() / m_item_grid_cell_size);
+        const int z = (int)floorf(xyz.getZ() / m_item_grid_cell_size);
+        m_item_grid[((uint64_t)(uint32_t)x << 32) | (uint32_t)z].push_back(i);
+    }
+    m_item_grid_dirty = false;
+}   // buildItemGrid
+
 //-----------------------------------------------------------------------------
 /** Checks if any item was collected by the given kart. This function calls
- *  collectedItem if an item was collected.
+ *  collectedItem if an item was collected. Only the items in the grid cells
+ *  close to the kart are tested, in the order of their index, so the result
+ *  is the same as testing all items.
  *  \param kart Pointer to the kart.
  */
 void  ItemManager::checkItemHit(AbstractKart* kart)
 {
-    // We could use m_items_in_quads to to check for item hits: take the quad
-    // of the graph node of the kart, and only check items in that quad. But
-    // then we also need to check for any adjacent quads (since an item just
-    // on the order of one quad might get hit from an adjacent quad). Then
-    // it is possible that a quad is that short that we need to test adjacent
-    // of adjacent quads. And check for items outside of the track.
-    // Since at this stace item detection is by far not a bottle neck,
-    // the original, simple and stable algorithm is left in place.
-
     /** Disable item collection detection for debug purposes. */
     if(m_disable_item_collection) return;
 
     // Spare tire karts don't collect items
     if ( dynamic_cast<SpareTireAI*>(kart->getController()) ) return;
 
-    for(AllItemTypes::iterator i =m_all_items.begin();
-                               i!=m_all_items.end();  i++)
+    const Vec3& xyz = kart->getXYZ();
+    // A kart at an invalid position can't hit any item
+    if (!std::isfinite(xyz.getX()) || !std::isfinite(xyz.getZ())) return;
+
+    if (m_item_grid_dirty)
+        buildItemGrid();
+
+    const float r = m_item_grid_hit_radius;
+    const float size = m_item_grid_cell_size;
+    const int min_x = (int)floorf((xyz.getX() - r) / size);
+    const int max_x = (int)floorf((xyz.getX() + r) / size);
+    const int min_z = (int)floorf((xyz.getZ() - r) / size);
+    const int max_z = (int)floorf((xyz.getZ() + r) / size);
+    m_item_grid_candidates.clear();
+    for (int x = min_x; x <= max_x; x++)
+    {
+        for (int z = min_z; z <= max_z; z++)
+        {
+            auto cell =
+                m_item_grid.find(((uint64_t)(uint32_t)x << 32) | (uint32_t)z);
+            if (cell == m_item_grid.end())
+                continue;
+            m_item_grid_candidates.insert(m_item_grid_candidates.end(),
+                                          cell->second.begin(),
+                                          cell->second.end());
+        }
+    }
+    std::sort(m_item_grid_candidates.begin(), m_item_grid_candidates.end());
+
+    for (int index : m_item_grid_candidates)
     {
+        ItemState* item = m_all_items[index];
         // Ignore items that have been collected or are not available atm
-        if ((!*i) || !(*i)->isAvailable() || (*i)->isUsedUp()) continue;
+        if (!item || !item->isAvailable() || item->isUsedUp()) continue;
 
         // Shielded karts can simply drive over bubble gums without any effect
         if ( kart->isShielded() &&
-             ( (*i)->getType() == ItemState::ITEM_BUBBLEGUM      ||
-               (*i)->getType() == ItemState::ITEM_BUBBLEGUM_NOLOK  ) )
+             ( item->getType() == ItemState::ITEM_BUBBLEGUM      ||
+               item->getType() == ItemState::ITEM_BUBBLEGUM_NOLOK  ) )
         {
             continue;
         }
@@ -395,11 +457,11 @@ void  ItemManager::checkItemHit(AbstractKart* kart)
 
         // To allow inlining and avoid including kart.hpp in item.hpp,
         // we pass the kart and the position separately.
-        if((*i)->hitKart(kart->getXYZ(), kart))
+        if(item->hitKart(xyz, kart))
         {
-            collectedItem(*i, kart);
+            collectedItem(item, kart);
         }   // if hit
-    }   // for m_all_items
+    }   // for m_item_grid_candidates
 }   // checkItemHit
 
 //-----------------------------------------------------------------------------
@@ -515,6 +577,7 @@ void ItemManager::deleteItem(ItemState *item)
  */
 void ItemManager::deleteItemInQuad(ItemState* item)
 {
+    m_item_grid_dirty = true;
     if(m_items_in_quads)
     {
         int sector = item->getGraphNode();
@@ -546,24 +609,39 @@ void ItemManager::switchItemsInternal(std::vector<ItemState*> &all_items)
     for(AllItemTypes::iterator i  = all_items.begin();
                                i != all_items.end();  i++)
     {
-        if(!*i) continue;
+        if(*i) switchItemInternal(*i);
+    }   // for all_items
 
-        ItemState::ItemType new_type = m_switch_to[(*i)->getType()];
+    toggleSwitchTicks();
+}   // switchItemsInternal
 
-        if (new_type == (*i)->getType())
-            continue;
-        if(m_switch_ticks<0)
-            (*i)->switchTo(new_type);
-        else
-            (*i)->switchBack();
-    }   // for all_items
+//-----------------------------------------------------------------------------
+/** Switches a single item, or switches it back if the items are currently
+ *  switched. Must be followed by a call to toggleSwitchTicks() once all
+ *  items are switched.
+ *  \param item The item to switch.
+ */
+void ItemManager::switchItemInternal(ItemState *item)
+{
+    ItemState::ItemType new_type = m_switch_to[item->getType()];
 
-    // if the items are already switched (m_switch_ticks >=0)
-    // then switch back, and set m_switch_ticks to -1 to indicate
-    // that the items are now back to normal.
-    m_switch_ticks = m_switch_ticks < 0 ? stk_config->m_item_switch_ticks : -1;
+    if (new_type == item->getType())
+        return;
+    if(m_switch_ticks<0)
+        item->switchTo(new_type);
+    else
+        item->switchBack();
+}   // switchItemInternal
 
-}   // switchItems
+//-----------------------------------------------------------------------------
+/** Called once all items are switched: if the items were already switched
+ *  (m_switch_ticks >=0) they are now switched back, so set m_switch_ticks
+ *  to -1 to indicate that the items are now back to normal.
+ */
+void ItemManager::toggleSwitchTicks()
+{
+    m_switch_ticks = m_switch_ticks < 0 ? stk_config->m_item_switch_ticks : -1;
+}   // toggleSwitchTicks
 
 //-----------------------------------------------------------------------------
 bool ItemManager::randomItemsForArena(const AlignedArray<btTransform>& pos)
@@ -35,6 +35,7 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class Kart;
@@ -107,6 +108,26 @@ private:
      *  field is undefined if no Graph exist, e.g. arena without navmesh. */
     std::vector< AllItemTypes > *m_items_in_quads;
 
+    /** A uniform grid in the XZ plane with the indices (in m_all_items) of
+     *  the items in each cell, used by checkItemHit to only test the items
+     *  close to a kart. The key contains the x and z cell coordinates. */
+    std::unordered_map<uint64_t, std::vector<int> > m_item_grid;
+
+    /** Size of a grid cell, at least twice m_item_grid_hit_radius so a kart
+     *  needs to test at most 2x2 cells. */
+    float m_item_grid_cell_size;
+
+    /** The maximum distance at which any item can be hit. */
+    float m_item_grid_hit_radius;
+
+    /** True if items were added, removed or restored since the grid was
+     *  built. */
+    bool m_item_grid_dirty;
+
+    /** Indices of the items to test for a kart, only stored here to avoid
+     *  frequent memory allocations. */
+    std::vector<int> m_item_grid_candidates;
+
     /** Stores all item models. */
     static std::vector<scene::IMesh *> m_item_mesh;
 
@@ -120,9 +141,16 @@ protected:
 
     void deleteItem(ItemState *item);
     void switchItemsInternal(std::vector < ItemState*> &all_items);
+    void switchItemInternal(ItemState *item);
+    void toggleSwitchTicks();
     void setSwitchItems(const std::vector<int> &switch_items);
     void insertItemInQuad(Item *item);
     void deleteItemInQuad(ItemState *item);
+    void buildItemGrid();
+    // ------------------------------------------------------------------------
+    /** Makes checkItemHit rebuild the item grid, must be called when the
+     *  position of an item changed. */
+    void invalidateItemGrid()                    { m_item_grid_dirty = true; }
 public:
              ItemManager();
     virtual ~ItemManager();
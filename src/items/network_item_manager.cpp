@@ -40,7 +40,11 @@ NetworkItemManager::NetworkItemManager()
                   : Rewinder({RN_ITEM_MANAGER}), ItemManager()
 {
     m_confirmed_switch_ticks = -1;
-    m_last_confirmed_item_ticks.clear();
+    m_first_item_event = 0;
+    m_end_item_event = 0;
+    m_saved_first_item_event = 0;
+    m_saved_state_size = 0;
+    m_item_event_cursors.clear();
     initServer();
 }   // NetworkItemManager
 
@@ -56,20 +60,40 @@ void NetworkItemManager::initServer()
         {
             if (!p->isValidated() || p->isWaitingForGame())
                 continue;
-            m_last_confirmed_item_ticks[p] = 0;
+            m_item_event_cursors[p] = { 0, m_first_item_event };
         }
     }
 }   // initServer
 
+//-----------------------------------------------------------------------------
+/** Adds a peer which joined a running game. It has not confirmed any event
+ *  yet, so it will receive all events still stored.
+ */
+void NetworkItemManager::addLiveJoinPeer(std::weak_ptr<STKPeer> peer)
+{
+    std::lock_guard<std::mutex> lock(m_live_players_mutex);
+    m_item_events.lock();
+    m_item_event_cursors[peer] = { 0, m_first_item_event };
+    m_item_events.unlock();
+}   // addLiveJoinPeer
+
+//-----------------------------------------------------------------------------
+/** Removes a peer which left the game, so its confirmations are not waited
+ *  for anymore.
+ */
+void NetworkItemManager::erasePeerInGame(std::weak_ptr<STKPeer> peer)
+{
+    std::lock_guard<std::mutex> lock(m_live_players_mutex);
+    m_item_events.lock();
+    m_item_event_cursors.erase(peer);
+    m_item_events.unlock();
+}   // erasePeerInGame
+
 //-----------------------------------------------------------------------------
 /** Destructor. Cleans up all items and meshes stored.
  */
 NetworkItemManager::~NetworkItemManager()
 {
-    for (ItemState* is : m_confirmed_state)
-    {
-        delete is;
-    }
 }   // ~NetworkItemManager
 
 //-----------------------------------------------------------------------------
@@ -97,10 +121,10 @@ void NetworkItemManager::collectedItem(ItemState *item, AbstractKart *kart)
         ItemManager::collectedItem(item, kart);
         // The server saves the collected item as item event info
         m_item_events.lock();
-        m_item_events.getData().emplace_back(World::getWorld()->getTicksSinceStart(),
-                                             item->getItemId(),
-                                             kart->getWorldKartId(),
-                                             item->getTicksTillReturn());
+        addItemEvent(ItemEventInfo(World::getWorld()->getTicksSinceStart(),
+                                   item->getItemId(),
+                                   kart->getWorldKartId(),
+                                   item->getTicksTillReturn()));
         m_item_events.unlock();
     }
     else
@@ -122,8 +146,7 @@ void NetworkItemManager::switchItems()
         m_item_events.lock();
         // Create a switch event - the constructor called determines
         // the type of the event automatically.
-        m_item_events.getData()
-                     .emplace_back(World::getWorld()->getTicksSinceStart());
+        addItemEvent(ItemEventInfo(World::getWorld()->getTicksSinceStart()));
         m_item_events.unlock();
     }
     ItemManager::switchItems();
@@ -152,15 +175,36 @@ Item* NetworkItemManager::dropNewItem(ItemState::ItemType type,
     assert(!server_xyz);
     // Server: store the data for this event:
     m_item_events.lock();
-    m_item_events.getData().emplace_back(World::getWorld()->getTicksSinceStart(),
-                                         type, item->getItemId(),
-                                         kart->getWorldKartId(),
-                                         item->getXYZ(),
-                                         item->getNormal());
+    addItemEvent(ItemEventInfo(World::getWorld()->getTicksSinceStart(),
+                               type, item->getItemId(),
+                               kart->getWorldKartId(),
+                               item->getXYZ(),
+                               item->getNormal()));
     m_item_events.unlock();
     return item;
 }   // dropNewItem
 
+// ----------------------------------------------------------------------------
+/** Appends an event to the ring buffer of item events, which is enlarged
+ *  if it is full. m_item_events must be locked.
+ *  \param iei The event to add.
+ */
+void NetworkItemManager::addItemEvent(const ItemEventInfo &iei)
+{
+    std::vector<ItemEventInfo> &events = m_item_events.getData();
+    if (m_end_item_event - m_first_item_event == events.size())
+    {
+        // Move the events to their index in the bigger buffer
+        std::vector<ItemEventInfo> bigger(
+            std::max<size_t>(16, events.size() * 2), iei);
+        for (uint64_t n = m_first_item_event; n < m_end_item_event; n++)
+            bigger[n % bigger.size()] = events[n % events.size()];
+        events.swap(bigger);
+    }
+    events[m_end_item_event % events.size()] = iei;
+    m_end_item_event++;
+}   // addItemEvent
+
 // ----------------------------------------------------------------------------
 /** Called by the GameProtocol when a confirmation for an item event is
  *  received by the server. Once all hosts have confirmed an event, it can be
@@ -172,49 +216,70 @@ void NetworkItemManager::setItemConfirmationTime(std::weak_ptr<STKPeer> peer,
                                                  int ticks)
 {
     assert(NetworkConfig::get()->isServer());
-    std::unique_lock<std::mutex> ul(m_live_players_mutex);
+    std::lock_guard<std::mutex> lock(m_live_players_mutex);
+    m_item_events.lock();
     // Peer may get removed earlier if peer request to go back to lobby
-    if (m_last_confirmed_item_ticks.find(peer) !=
-        m_last_confirmed_item_ticks.end() &&
-        ticks > m_last_confirmed_item_ticks.at(peer))
-        m_last_confirmed_item_ticks.at(peer) = ticks;
+    auto cursor = m_item_event_cursors.find(peer);
+    if (cursor != m_item_event_cursors.end() &&
+        ticks > cursor->second.m_ticks)
+    {
+        cursor->second.m_ticks = ticks;
+        // Since the event list is sorted, the peer has received all events
+        // before the confirmed time.
+        uint64_t &n = cursor->second.m_event;
+        while (n < m_end_item_event && getItemEvent(n).getTicks() < ticks)
+            n++;
+    }
 
     // Now discard unneeded events and expired (disconnected) peer, i.e. all
     // events that have been confirmed by all clients:
-    int min_time = std::numeric_limits<int32_t>::max();
-    for (auto it = m_last_confirmed_item_ticks.begin();
-         it != m_last_confirmed_item_ticks.end();)
+    uint64_t first = m_end_item_event;
+    for (auto it = m_item_event_cursors.begin();
+         it != m_item_event_cursors.end();)
     {
         if (it->first.expired())
         {
-            it = m_last_confirmed_item_ticks.erase(it);
+            it = m_item_event_cursors.erase(it);
         }
         else
         {
-            if (it->second < min_time) min_time = it->second;
+            if (it->second.m_event < first) first = it->second.m_event;
             it++;
         }
     }
-    ul.unlock();
-
-    // Find the last entry before the minimal confirmed time.
-    // Since the event list is sorted, all events up to this
-    // entry can be deleted.
-    m_item_events.lock();
-    auto p = m_item_events.getData().begin();
-    while (p != m_item_events.getData().end() && p->getTicks() < min_time)
-        p++;
-    m_item_events.getData().erase(m_item_events.getData().begin(), p);
+    m_first_item_event = first;
     m_item_events.unlock();
 
 }   // setItemConfirmationTime
 
+// ----------------------------------------------------------------------------
+/** Returns the number of bytes at the start of the last saved state which
+ *  only contain events the peer has already confirmed, so they don't need
+ *  to be sent to this peer again.
+ *  \param peer The peer the state is sent to.
+ */
+unsigned NetworkItemManager::getConfirmedStateSize(
+                                                 std::shared_ptr<STKPeer> peer)
+{
+    std::lock_guard<std::mutex> lock(m_live_players_mutex);
+    auto cursor = m_item_event_cursors.find(peer);
+    if (cursor == m_item_event_cursors.end() ||
+        cursor->second.m_event <= m_saved_first_item_event)
+        return 0;
+    uint64_t n = cursor->second.m_event - m_saved_first_item_event;
+    if (n >= m_saved_item_event_offsets.size())
+        return m_saved_state_size;
+    return m_saved_item_event_offsets[n];
+}   // getConfirmedStateSize
+
 //-----------------------------------------------------------------------------
 /** Saves the state of all items. This is done by using a state that has
  *  been confirmed by all clients as a base, and then only adding any
  *  changes applied to that state later. As clients keep on confirming events
  *  the confirmed event will be moved forward in time, and older events can
- *  be deleted (and not sent to the clients anymore).
+ *  be deleted (and not sent to the clients anymore). The offset of each
+ *  event is saved, so that GameProtocol can remove the events a client has
+ *  already confirmed from the state it sends to that client.
  *  This function is also called on the client in the first frame of a race
  *  to save the initial state, which is the first confirmed state by all
  *  clients.
@@ -225,7 +290,10 @@ BareNetworkString* NetworkItemManager::saveState(std::vector<std::string>* ru)
     // On the server:
     // ==============
     m_item_events.lock();
-    uint16_t n = (uint16_t)m_item_events.getData().size();
+    uint16_t n = (uint16_t)(m_end_item_event - m_first_item_event);
+    m_saved_first_item_event = m_first_item_event;
+    m_saved_item_event_offsets.clear();
+    m_saved_state_size = 0;
     if(n==0)
     {
         BareNetworkString *s = new BareNetworkString();
@@ -236,10 +304,12 @@ BareNetworkString* NetworkItemManager::saveState(std::vector<std::string>* ru)
     BareNetworkString *s =
         new BareNetworkString(n * (  sizeof(int) + sizeof(uint16_t)
                                    + sizeof(uint8_t)              ) );
-    for (auto p : m_item_events.getData())
+    for (uint64_t i = m_first_item_event; i < m_end_item_event; i++)
     {
-        p.saveState(s);
+        m_saved_item_event_offsets.push_back(s->size());
+        getItemEvent(i).saveState(s);
     }
+    m_saved_state_size = s->size();
     m_item_events.unlock();
     return s;
 }   // saveState
@@ -254,19 +324,32 @@ void NetworkItemManager::forwardTime(int ticks)
     int new_ticks = World::getWorld()->getTicksSinceStart() + ticks;
     World::getWorld()->setTicksForRewind(new_ticks);
 
-    for(auto &i : m_confirmed_state)
+    for(ItemState &is : m_confirmed_state)
     {
-        if (i) i->update(ticks);
-    }   // for m_all_items
+        if (is.getType() != ItemState::ITEM_NONE) is.update(ticks);
+    }   // for m_confirmed_state
     if(m_switch_ticks>ticks)
         m_switch_ticks -= ticks;
     else if (m_switch_ticks >= 0)
     {
-        switchItemsInternal(m_confirmed_state);
+        switchConfirmedItems();
         m_switch_ticks = -1;
     }
 }   // forwardTime
 
+//-----------------------------------------------------------------------------
+/** Switches all confirmed items, the equivalent of switchItemsInternal()
+ *  for the confirmed state.
+ */
+void NetworkItemManager::switchConfirmedItems()
+{
+    for (ItemState &is : m_confirmed_state)
+    {
+        if (is.getType() != ItemState::ITEM_NONE) switchItemInternal(&is);
+    }
+    toggleSwitchTicks();
+}   // switchConfirmedItems
+
 //-----------------------------------------------------------------------------
 /** Restores the state of the items to the current world time. It takes the
  *  last saved confirmed state, applies any updates from the server, and
@@ -368,8 +451,8 @@ void NetworkItemManager::restoreState(BareNetworkString *buffer, int count)
                       iei.getIndex(),
                       iei.getTicks(), iei.isItemCollection(), iei.isNewItem(),
                       iei.getTicksTillReturn(),
-                      iei.getIndex() < (int)m_confirmed_state.size() && iei.getIndex() != -1 ?
-                      m_confirmed_state[iei.getIndex()] : NULL);
+                      iei.getIndex() != -1 && hasConfirmedState(iei.getIndex()) ?
+                      &m_confirmed_state[iei.getIndex()] : NULL);
         // 1.2) If the event needs to be applied, forward
         //      the time to the time of this event:
         // ----------------------------------------------
@@ -389,54 +472,51 @@ void NetworkItemManager::restoreState(BareNetworkString *buffer, int count)
             // An item on the track was collected:
             AbstractKart *kart = world->getKart(iei.getKartId());
 
-            assert(m_confirmed_state[index] != NULL);
-            m_confirmed_state[index]->collected(kart); // Collect item
+            assert(hasConfirmedState(index));
+            ItemState &is = m_confirmed_state[index];
+            is.collected(kart); // Collect item
             // Reset till ticks return from state (required for eating banana with bomb)
             int ttr = iei.getTicksTillReturn();
-            m_confirmed_state[index]->setTicksTillReturn(ttr);
+            is.setTicksTillReturn(ttr);
 
-            if (m_confirmed_state[index]->isUsedUp())
-            {
-                delete m_confirmed_state[index];
-                m_confirmed_state[index] = NULL;
-            }
+            if (is.isUsedUp())
+                is = ItemState(ItemState::ITEM_NONE);
         }
         else if(iei.isNewItem())
         {
             AbstractKart *kart = world->getKart(iei.getKartId());
-            ItemState *is = new ItemState(iei.getNewItemType(), kart,
-                                          iei.getIndex()             );
-            is->initItem(iei.getNewItemType(), iei.getXYZ(), iei.getNormal());
+            ItemState is(iei.getNewItemType(), kart, iei.getIndex());
+            is.initItem(iei.getNewItemType(), iei.getXYZ(), iei.getNormal());
             if (m_switch_ticks >= 0)
             {
-                ItemState::ItemType new_type = m_switch_to[is->getType()];
-                is->switchTo(new_type);
+                ItemState::ItemType new_type = m_switch_to[is.getType()];
+                is.switchTo(new_type);
             }
 
             // A new confirmed item must either be inserted at the end of all
             // items, or in an existing unused entry.
-            if (m_confirmed_state.size() <= is->getItemId())
+            if (m_confirmed_state.size() <= is.getItemId())
             {
                 // In case that the server should send items in the wrong
                 // order, e.g. it sends an item for index n+2, then the item
-                // for index n -> we might need to add NULL item states
+                // for index n -> we might need to add unused item states
                 // into the state array to make sure the indices are correct.
-                while(m_confirmed_state.size()<is->getItemId())
-                    m_confirmed_state.push_back(NULL);
+                m_confirmed_state.resize(is.getItemId(),
+                                         ItemState(ItemState::ITEM_NONE));
                 m_confirmed_state.push_back(is);
             }
             else
             {
                 // If the new item has an already existing index,
                 // the slot in the confirmed state array must be free
-                assert(m_confirmed_state[is->getItemId()] == NULL);
-                m_confirmed_state[is->getItemId()] = is;
+                assert(!hasConfirmedState(is.getItemId()));
+                m_confirmed_state[is.getItemId()] = is;
             }
         }
         else if(iei.isSwitch())
         {
             // Switch all confirmed items:
-            ItemManager::switchItemsInternal(m_confirmed_state);
+            switchConfirmedItems();
         }
         else
         {
@@ -478,8 +558,8 @@ void NetworkItemManager::restoreState(BareNetworkString *buffer, int count)
     for(unsigned int i=0; i<max_index; i++)
     {
         ItemState *item     = m_all_items[i];
-        const ItemState *is = i < m_confirmed_state.size() 
-                            ? m_confirmed_state[i] : NULL;
+        const ItemState *is = hasConfirmedState(i)
+                            ? &m_confirmed_state[i] : NULL;
         // For every *(ItemState*)item = *is, all deactivated ticks, item id
         // ... will be copied from item state to item
         if (is && item)
@@ -507,6 +587,8 @@ void NetworkItemManager::restoreState(BareNetworkString *buffer, int count)
     }   // for i < max_index
     // Clean up the rest
     m_all_items.resize(m_confirmed_state.size());
+    // Copying the confirmed state can also change the position of items
+    invalidateItemGrid();
 
     // Now set the clock back to the 'rewindto' time:
     world->setTicksForRewind(rewind_to_time);
@@ -545,20 +627,14 @@ void NetworkItemManager::restoreCompleteState(const BareNetworkString& buffer)
     m_confirmed_state_time = buffer.getUInt32();
     m_confirmed_switch_ticks = buffer.getUInt32();
     uint32_t all_items = buffer.getUInt32();
-    for (ItemState* is : m_confirmed_state)
-    {
-        delete is;
-    }
     m_confirmed_state.clear();
+    m_confirmed_state.reserve(all_items);
     for (unsigned i = 0; i < all_items; i++)
     {
         const bool has_item = buffer.getUInt8() == 1;
         if (has_item)
-        {
-            ItemState* is = new ItemState(buffer);
-            m_confirmed_state.push_back(is);
-        }
+            m_confirmed_state.push_back(ItemState(buffer));
         else
-            m_confirmed_state.push_back(NULL);
+            m_confirmed_state.push_back(ItemState(ItemState::ITEM_NONE));
     }
 }   // restoreCompleteState
@@ -46,8 +46,11 @@ class NetworkItemManager : public Rewinder, public ItemManager
 private:
 
     /** A client stores a 'confirmed' item event state, which is based on the
-      * server data. This is used in case of rewind. */
-    std::vector<ItemState*> m_confirmed_state;
+      * server data. This is used in case of rewind. The states are stored
+      * by value, so a rewind doesn't need to allocate a state for each new
+      * item, and forwarding the time walks contiguous memory. Unused
+      * entries have the type ITEM_NONE. */
+    std::vector<ItemState> m_confirmed_state;
 
     /** The switch ticks value at the lime of the last confirmed state. */
     int m_confirmed_switch_ticks;
@@ -58,14 +61,58 @@ private:
     /** Allow remove or add peer live. */
     std::mutex m_live_players_mutex;
 
-    /** Stores on the server the latest confirmed tick from each client. */
-    std::map<std::weak_ptr<STKPeer>, int32_t,
-        std::owner_less<std::weak_ptr<STKPeer> > > m_last_confirmed_item_ticks;
-
-    /** List of all items events. */
+    /** The latest confirmed tick of a client, and the sequence number of the
+     *  first item event which it has not confirmed yet. */
+    struct ItemEventCursor
+    {
+        int32_t  m_ticks;
+        uint64_t m_event;
+    };
+
+    /** Stores on the server the item event cursor of each client. Only
+     *  changed while both m_live_players_mutex and m_item_events are
+     *  locked. */
+    std::map<std::weak_ptr<STKPeer>, ItemEventCursor,
+        std::owner_less<std::weak_ptr<STKPeer> > > m_item_event_cursors;
+
+    /** Ring buffer of all item events which have not been confirmed by all
+     *  clients, sorted by time. The event with sequence number n is stored
+     *  at index n % size(). */
     Synchronised< std::vector<ItemEventInfo> > m_item_events;
 
+    /** Sequence number of the oldest event in m_item_events, and the one
+     *  after the newest event. Protected by the lock of m_item_events. */
+    uint64_t m_first_item_event;
+    uint64_t m_end_item_event;
+
+    /** Sequence number of the first event in the last saved state, and the
+     *  offset of each event in that state. Only used in the main thread. */
+    uint64_t m_saved_first_item_event;
+    std::vector<unsigned> m_saved_item_event_offsets;
+
+    /** Size of the last saved state. */
+    unsigned m_saved_state_size;
+
     void forwardTime(int ticks);
+    void addItemEvent(const ItemEventInfo &iei);
+    // ------------------------------------------------------------------------
+    /** Returns the event with the given sequence number, m_item_events must
+     *  be locked. */
+    ItemEventInfo& getItemEvent(uint64_t n)
+    {
+        std::vector<ItemEventInfo> &events = m_item_events.getData();
+        return events[n % events.size()];
+    }   // getItemEvent
+    // ------------------------------------------------------------------------
+    void switchConfirmedItems();
+    // ------------------------------------------------------------------------
+    /** Returns true if there is a confirmed item with the given index. */
+    bool hasConfirmedState(unsigned int index) const
+    {
+        return index < m_confirmed_state.size() &&
+               m_confirmed_state[index].getType() != ItemState::ITEM_NONE;
+    }   // hasConfirmedState
+    // ------------------------------------------------------------------------
 public:
 
     static bool m_network_item_debugging;
@@ -95,17 +142,11 @@ public:
     // ------------------------------------------------------------------------
     virtual void undoEvent(BareNetworkString*) OVERRIDE {};
     // ------------------------------------------------------------------------
-    void addLiveJoinPeer(std::weak_ptr<STKPeer> peer)
-    {
-        std::lock_guard<std::mutex> lock(m_live_players_mutex);
-        m_last_confirmed_item_ticks[peer] = 0;
-    }
+    void addLiveJoinPeer(std::weak_ptr<STKPeer> peer);
     // ------------------------------------------------------------------------
-    void erasePeerInGame(std::weak_ptr<STKPeer> peer)
-    {
-        std::lock_guard<std::mutex> lock(m_live_players_mutex);
-        m_last_confirmed_item_ticks.erase(peer);
-    }
+    void erasePeerInGame(std::weak_ptr<STKPeer> peer);
+    // ------------------------------------------------------------------------
+    unsigned getConfirmedStateSize(std::shared_ptr<STKPeer> peer);
     // ------------------------------------------------------------------------
     void saveCompleteState(BareNetworkString* buffer) const;
     // ------------------------------------------------------------------------
@@ -1586,8 +1586,7 @@ void Kart::update(int ticks)
                ((Vec3(0, 1, 0).rotate(q.getAxis(), q.getAngle())));
 
         if (Track::getCurrentTrack()->isAutoRescueEnabled() &&
-            (!m_terrain_info->getMaterial() ||
-            !m_terrain_info->getMaterial()->hasGravity()) &&
+            !m_terrain_info->hasTerrainFlag(Material::TF_GRAVITY) &&
             !has_animation_before && fabs(roll) > 60 * DEGREE_TO_RAD &&
             fabs(getSpeed()) < 3.0f)
         {
@@ -1609,7 +1608,7 @@ void Kart::update(int ticks)
         btRigidBody *body = getVehicle()->getRigidBody();
 
         // If the material should overwrite the gravity,
-        if (material && material->hasGravity())
+        if (m_terrain_info->hasTerrainFlag(Material::TF_GRAVITY))
         {
             Vec3 normal = m_terrain_info->getNormal();
             gravity = normal * -g;
@@ -1688,12 +1687,14 @@ void Kart::update(int ticks)
     }
     else
     {
-        if (!has_animation_before && material->isDriveReset() && isOnGround())
+        if (!has_animation_before && isOnGround() &&
+            m_terrain_info->hasTerrainFlag(Material::TF_DRIVE_RESET))
         {
             RescueAnimation::create(this);
             m_last_factor_engine_sound = 0.0f;
         }
-        else if(material->isZipper()     && isOnGround())
+        else if (isOnGround() &&
+                 m_terrain_info->hasTerrainFlag(Material::TF_ZIPPER))
         {
             handleZipper(material);
             showZipperFire();
@@ -2029,7 +2030,8 @@ void Kart::handleMaterialGFX(float dt)
     // on top of a surface (i.e. not falling), actually touching
     // something with the wheels, and the material has not the
     // below surface property set.
-    if (material && isOnGround() && !material->isBelowSurface() &&
+    if (material && isOnGround() &&
+        !m_terrain_info->hasTerrainFlag(Material::TF_BELOW_SURFACE) &&
         !getKartAnimation()      && UserConfigParams::m_particles_effects > 1)
     {
 
@@ -2055,7 +2057,8 @@ void Kart::handleMaterialGFX(float dt)
     // --------------------------------------------------------------
     if (m_controller->isLocalPlayerController() && !hasFinishedRace())
     {
-        bool falling = material && material->hasFallingEffect() && !m_flying;
+        bool falling = !m_flying &&
+            m_terrain_info->hasTerrainFlag(Material::TF_FALLING_EFFECT);
         if (falling)
         {
             m_falling_time -= dt;
@@ -2621,9 +2624,8 @@ void Kart::updatePhysics(int ticks)
     updateSliding();
 
     // Cap speed if necessary
-    const Material *m = getMaterial();
-
-    float min_speed =  m && m->isZipper() ? m->getZipperMinSpeed() : -1.0f;
+    float min_speed = m_terrain_info->hasTerrainFlag(Material::TF_ZIPPER)
+                    ? getMaterial()->getZipperMinSpeed() : -1.0f;
     m_max_speed->setMinSpeed(min_speed);
     m_max_speed->update(ticks);
 
@@ -2869,8 +2871,7 @@ void Kart::updateSliding()
     // high adhesion material), which is useful for e.g. banked curves.
     // We don't have per-wheel material, so the test for special material
     // with high adhesion is done per kart (not per wheel).
-    const Material * material = getMaterial();
-    if (material && material->highTireAdhesion())
+    if (m_terrain_info->hasTerrainFlag(Material::TF_HIGH_ADHESION))
     {
         for (int i = 0; i < m_vehicle->getNumWheels(); i++)
         {
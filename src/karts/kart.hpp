@@ -38,6 +38,7 @@
 class AbstractKartAnimation;
 class Attachment;
 class btKart;
+class btKartRaycaster;
 class btUprightConstraint;
 class Controller;
 class HitEffect;
@@ -115,7 +116,7 @@ protected:
     /** Handles the powerup of a kart. */
     Powerup *m_powerup;
 
-    std::unique_ptr<btVehicleRaycaster> m_vehicle_raycaster;
+    std::unique_ptr<btKartRaycaster> m_vehicle_raycaster;
 
     std::unique_ptr<btKart> m_vehicle;
 
@@ -204,6 +204,7 @@
 #include "input/wiimote_manager.hpp"
 #include "io/file_manager.hpp"
 #include "items/attachment_manager.hpp"
+#include "items/flyable.hpp"
 #include "items/item_manager.hpp"
 #include "items/network_item_manager.hpp"
 #include "items/powerup_manager.hpp"
@@ -226,6 +227,7 @@
 #include "network/protocols/client_lobby.hpp"
 #include "network/protocols/server_lobby.hpp"
 #include "network/race_event_manager.hpp"
+#include "network/request_limiter.hpp"
 #include "network/rewind_manager.hpp"
 #include "network/rewind_queue.hpp"
 #include "network/server.hpp"
@@ -236,6 +238,7 @@
 #include "network/stk_peer.hpp"
 #include "online/profile_manager.hpp"
 #include "online/request_manager.hpp"
+#include "physics/physics.hpp"
 #include "race/grand_prix_manager.hpp"
 #include "race/highscore_manager.hpp"
 #include "race/history.hpp"
@@ -251,8 +254,10 @@
 #include "states_screens/dialogs/message_dialog.hpp"
 #include "tips/tips_manager.hpp"
 #include "tracks/arena_graph.hpp"
+#include "tracks/drive_graph.hpp"
 #include "tracks/track.hpp"
 #include "tracks/track_manager.hpp"
+#include "tracks/track_residency_pool.hpp"
 #include "utils/command_line.hpp"
 #include "utils/constants.hpp"
 #include "utils/crash_reporting.hpp"
@@ -559,6 +564,10 @@ void cmdLineHelp()
                               "laps.\n"
     "       --profile-time=n   Enable automatic driven profile mode for n "
                               "seconds.\n"
+    "       --broadphase=NAME  Use the given physics broadphase (axis-sweep,\n"
+    "                          axis-sweep-32 or dbvt) for all tracks.\n"
+    "       --full-tick-replay Use the full world update when replaying ticks in\n"
+    "                          network games (to compare performance).\n"
     "       --unlock-all       Permanently unlock all karts and tracks for testing.\n"
     "       --no-unlock-all    Disable unlock-all (i.e. base unlocking on player achievement).\n"
     "       --no-graphics      Do not display the actual race.\n"
@@ -1585,6 +1594,12 @@ int handleCmdLine(bool has_server_config, bool has_parent_process)
             RaceManager::get()->setNumLaps(n);
         }
     }   // --profile-laps
+
+    if (CommandLine::has("--broadphase", &s))
+        UserConfigParams::m_broadphase = s;
+
+    if (CommandLine::has("--full-tick-replay"))
+        UserConfigParams::m_full_tick_replay = true;
     
     if(CommandLine::has("--unlock-all"))
     {
@@ -2447,6 +2462,7 @@ static void cleanSuperTuxKart()
     if(powerup_manager)         delete powerup_manager;
     ProjectileManager::destroy();
     if(kart_properties_manager) delete kart_properties_manager;
+    TrackResidencyPool::destroy();
     if(track_manager)           delete track_manager;
     if(material_manager)        delete material_manager;
     if(history)                 delete history;
@@ -2553,6 +2569,8 @@ void runUnitTests()
     NetworkString::unitTesting();
     Log::info("UnitTest", "SocketAddress");
     SocketAddress::unitTesting();
+    Log::info("UnitTest", "RequestLimiter");
+    RequestLimiter::unitTesting();
     Log::info("UnitTest", "StringUtils::versionToInt");
     StringUtils::unitTesting();
 
@@ -2596,12 +2614,21 @@ void runUnitTests()
     Log::info("UnitTest", "Arena Graph");
     ArenaGraph::unitTesting();
 
+    Log::info("UnitTest", "Drive Graph");
+    DriveGraph::unitTesting();
+
     Log::info("UnitTest", "Fonts for translation");
     font_manager->unitTesting();
 
     Log::info("UnitTest", "RewindQueue");
     RewindQueue::unitTesting();
 
+    Log::info("UnitTest", "Physics collision list");
+    Physics::unitTesting();
+
+    Log::info("UnitTest", "Flyable track sweep");
+    Flyable::unitTesting();
+
     Log::info("UnitTest", "=====================");
     Log::info("UnitTest", "Testing successful   ");
     Log::info("UnitTest", "=====================");
@@ -584,6 +584,11 @@ void MainLoop::run()
             bool fast_forward = NetworkConfig::get()->isNetworking() &&
                 NetworkConfig::get()->isClient() &&
                 num_steps > stk_config->time2Ticks(1.0f);
+            // A server catching up after a stall only needs to update the
+            // simulation for all but the last tick
+            const bool catch_up = NetworkConfig::get()->isNetworking() &&
+                NetworkConfig::get()->isServer() &&
+                !UserConfigParams::m_full_tick_replay;
             for (int i = 0; i < num_steps; i++)
             {
                 if (World::getWorld() && history->replayHistory())
@@ -603,7 +608,11 @@ void MainLoop::run()
                 PROFILER_PUSH_CPU_MARKER("Update race", 0, 255, 255);
                 if (World::getWorld())
                 {
+                    World::getWorld()->setSimulationOnly(catch_up &&
+                                                         i < num_steps - 1);
                     updateRace(1, fast_forward);
+                    if (World::getWorld())
+                        World::getWorld()->setSimulationOnly(false);
                 }
                 PROFILER_POP_CPU_MARKER();
 
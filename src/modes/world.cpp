@@ -142,6 +142,7 @@ World::World() : WorldStatus()
     m_schedule_exit_race = false;
     m_schedule_tutorial  = false;
     m_is_network_world   = false;
+    m_simulation_only    = false;
 
     m_stop_music_when_dialog_open = true;
 
@@ -1160,7 +1161,11 @@ void World::update(int ticks)
     PROFILER_POP_CPU_MARKER();
 
     PROFILER_PUSH_CPU_MARKER("World::update (Track object manager)", 0x20, 0x7F, 0x40);
-    Track::getCurrentTrack()->getTrackObjectManager()->update(stk_config->ticks2Time(ticks));
+    TrackObjectManager* tom = Track::getCurrentTrack()->getTrackObjectManager();
+    if (m_simulation_only)
+        tom->updateSimulation(stk_config->ticks2Time(ticks));
+    else
+        tom->update(stk_config->ticks2Time(ticks));
     PROFILER_POP_CPU_MARKER();
 
     PROFILER_PUSH_CPU_MARKER("World::update (Kart::upate)", 0x40, 0x7F, 0x00);
@@ -1180,7 +1185,8 @@ void World::update(int ticks)
             m_karts[i]->makeKartRest();
     }
     PROFILER_POP_CPU_MARKER();
-    if(RaceManager::get()->isRecordingRace()) ReplayRecorder::get()->update(ticks);
+    if (!m_simulation_only && RaceManager::get()->isRecordingRace())
+        ReplayRecorder::get()->update(ticks);
 
     PROFILER_PUSH_CPU_MARKER("World::update (projectiles)", 0xa0, 0x7F, 0x00);
     ProjectileManager::get()->update(ticks);
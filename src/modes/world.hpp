@@ -184,6 +184,11 @@ protected:
 
     bool m_ended_early;
 
+    /** If set only the parts of the world which affect the simulation
+     *  (karts, physics, items, checklines and flyables) are updated, which
+     *  is used to replay ticks in a rewind or when a server catches up. */
+    bool m_simulation_only;
+
     virtual void  onGo() OVERRIDE;
     /** Returns true if the race is over. Must be defined by all modes. */
     virtual bool  isRaceOver() = 0;
@@ -400,6 +405,13 @@ public:
     // ------------------------------------------------------------------------
     bool isNetworkWorld() const { return m_is_network_world; }
     // ------------------------------------------------------------------------
+    void setSimulationOnly(bool simulation_only)
+                                       { m_simulation_only = simulation_only; }
+    // ------------------------------------------------------------------------
+    /** Returns true if the current tick only needs to update the simulation
+     *  and nothing which is only shown to the player. */
+    bool isSimulationOnly() const { return m_simulation_only; }
+    // ------------------------------------------------------------------------
     /** Set the team arrow on karts if necessary*/
     void initTeamArrows(AbstractKart* k);
     // ------------------------------------------------------------------------
@@ -28,6 +28,8 @@
 namespace CompressNetworkBody
 {
     using namespace MiniGLM;
+    /** Number of bytes written by compress(). */
+    const int COMPRESSED_SIZE = 28;
     // ------------------------------------------------------------------------
     /** Set body and motion state of bullet object with compressed values. */
     inline void setCompressedValues(float x, float y, float z,
@@ -18,6 +18,7 @@
 
 #include "network/network_config.hpp"
 #include "network/network_player_profile.hpp"
+#include "network/request_limiter.hpp"
 #include "network/server_config.hpp"
 #include "network/socket_address.hpp"
 #include "network/stk_host.hpp"
@@ -53,6 +54,10 @@ void showHelp()
     std::cout << "listpeers, List all peers with host ID and IP." << std::endl;
     std::cout << "listban, List IP ban list of server." << std::endl;
     std::cout << "speedstats, Show upload and download speed." << std::endl;
+    std::cout << "requeststats, Show accepted and rejected requests." <<
+        std::endl;
+    std::cout << "lobbystats, Show time used by lobby states and events." <<
+        std::endl;
 }   // showHelp
 
 // ----------------------------------------------------------------------------
@@ -178,6 +183,26 @@ void mainLoop(STKHost* host)
                 "   Download speed (KBps): " <<
                 (float)host->getDownloadSpeed() / 1024.0f  << std::endl;
         }
+        else if (str == "lobbystats")
+        {
+            auto sl = LobbyProtocol::get<ServerLobby>();
+            if (sl)
+                std::cout << sl->getProfiler().dump();
+        }
+        else if (str == "requeststats" && NetworkConfig::get()->isServer())
+        {
+            RequestLimiter* rl = host->getRequestLimiter();
+            if (rl && rl->isEnabled())
+            {
+                std::cout << "Accepted requests: " << rl->getAccepted() <<
+                    "   Rejected by IP: " << rl->getRejectedByIP() <<
+                    "   Rejected by network: " << rl->getRejectedByPrefix() <<
+                    "   Rejected by full table: " << rl->getRejectedByFull() <<
+                    std::endl;
+            }
+            else
+                std::cout << "Request limiting is disabled." << std::endl;
+        }
         else
         {
             std::cout << "Unknown command: " << str << std::endl;
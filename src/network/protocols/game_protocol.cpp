@@ -62,13 +62,16 @@ GameProtocol::GameProtocol()
 {
     m_network_item_manager = static_cast<NetworkItemManager*>
         (Track::getCurrentTrack()->getItemManager());
+    m_item_state_offset = -1;
     m_data_to_send = getNetworkString();
+    m_peer_data_to_send = getNetworkString();
 }   // GameProtocol
 
 //-----------------------------------------------------------------------------
 GameProtocol::~GameProtocol()
 {
     delete m_data_to_send;
+    delete m_peer_data_to_send;
 }   // ~GameProtocol
 
 //-----------------------------------------------------------------------------
@@ -288,6 +291,8 @@ void GameProtocol::startNewState()
     m_data_to_send->clear();
     m_data_to_send->addUInt8(GP_STATE)
         .addUInt32(World::getWorld()->getTicksSinceStart());
+    m_state_offsets.clear();
+    m_item_state_offset = -1;
 }   // startNewState
 
 // ----------------------------------------------------------------------------
@@ -298,6 +303,7 @@ void GameProtocol::startNewState()
 void GameProtocol::addState(BareNetworkString *buffer)
 {
     assert(NetworkConfig::get()->isServer());
+    m_state_offsets.push_back((unsigned)m_data_to_send->getBuffer().size());
     m_data_to_send->addUInt16(buffer->size());
     (*m_data_to_send) += *buffer;
 }   // addState
@@ -324,16 +330,61 @@ void GameProtocol::finalizeState(std::vector<std::string>& cur_rewinder)
         names.insert(names.end(), rewinder.begin(), rewinder.end());
     }
     buffer.insert(pos, names.begin(), names.end());
+
+    // The states are added in the same order as the names
+    for (unsigned i = 0; i < cur_rewinder.size() &&
+         i < m_state_offsets.size(); i++)
+    {
+        if (cur_rewinder[i] == m_network_item_manager->getUniqueIdentity())
+            m_item_state_offset = m_state_offsets[i] + (int)names.size();
+    }
 }   // finalizeState
 
 // ----------------------------------------------------------------------------
 /** Called when the last state information has been added and the message
- *  can be sent to the clients.
+ *  can be sent to the clients. Item events which a client has already
+ *  confirmed are removed from the state sent to that client.
  */
 void GameProtocol::sendState()
 {
     assert(NetworkConfig::get()->isServer());
-    sendMessageToPeers(m_data_to_send, /*reliable*/false);
+    if (m_item_state_offset < 0)
+    {
+        sendMessageToPeers(m_data_to_send, /*reliable*/false);
+        return;
+    }
+
+    const std::vector<uint8_t>& buffer = m_data_to_send->getBuffer();
+    const unsigned item_state_size = (buffer[m_item_state_offset] << 8) |
+                                     buffer[m_item_state_offset + 1];
+    // The data before the item state is the same for all peers, so it is
+    // only copied once. For each peer only the item state size and the data
+    // after the confirmed events are replaced.
+    std::vector<uint8_t>& peer_buffer = m_peer_data_to_send->getBuffer();
+    bool has_prefix = false;
+    for (auto& peer : STKHost::get()->getPeers())
+    {
+        if (!peer->isValidated() || peer->isWaitingForGame())
+            continue;
+        unsigned confirmed =
+            m_network_item_manager->getConfirmedStateSize(peer);
+        if (confirmed == 0 || confirmed > item_state_size)
+        {
+            peer->sendPacket(m_data_to_send, /*reliable*/false);
+            continue;
+        }
+        if (!has_prefix)
+        {
+            peer_buffer.assign(buffer.begin(),
+                               buffer.begin() + m_item_state_offset);
+            has_prefix = true;
+        }
+        peer_buffer.resize(m_item_state_offset);
+        m_peer_data_to_send->addUInt16((uint16_t)(item_state_size - confirmed));
+        peer_buffer.insert(peer_buffer.end(),
+            buffer.begin() + m_item_state_offset + 2 + confirmed, buffer.end());
+        peer->sendPacket(m_peer_data_to_send, /*reliable*/false);
+    }
 }   // sendState
 
 // ----------------------------------------------------------------------------
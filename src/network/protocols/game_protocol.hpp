@@ -56,6 +56,10 @@ private:
      *  next. */
     NetworkString *m_data_to_send;
 
+    /** The state sent to a peer which has already confirmed some item events,
+     *  which are removed from the copy of m_data_to_send in here. */
+    NetworkString *m_peer_data_to_send;
+
     /** The server might request that the world clock of a client is adjusted
      *  to reduce number of rollbacks. */
     std::vector<int8_t> m_adjust_time;
@@ -80,6 +84,12 @@ private:
     void handleItemEventConfirmation(Event *event);
     static std::weak_ptr<GameProtocol> m_game_protocol[PT_COUNT];
     NetworkItemManager* m_network_item_manager;
+    /** Offset of the state of each rewinder in m_data_to_send before the
+     *  names of the rewinders are inserted. */
+    std::vector<unsigned> m_state_offsets;
+    /** Offset of the size of the item manager state in m_data_to_send, or
+     *  -1 if it is not part of the state. */
+    int m_item_state_offset;
     // Maximum value of values are only 32768
     std::tuple<uint8_t, uint16_t, uint16_t, uint16_t>
                                                 compressAction(const Action& a)
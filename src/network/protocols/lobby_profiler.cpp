@@ -0,0 +1,122 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "network/protocols/lobby_profiler.hpp"
+
+#include <cstdio>
+
+// ----------------------------------------------------------------------------
+void LobbyProfiler::Histogram::add(uint64_t us)
+{
+    m_count++;
+    m_total_us += us;
+    if (us > m_max_us)
+        m_max_us = us;
+    uint64_t ms = us / 1000;
+    unsigned bucket = 0;
+    while (bucket < BUCKETS - 1 && ms >= (1ull << bucket))
+        bucket++;
+    m_buckets[bucket]++;
+}   // add
+
+// ----------------------------------------------------------------------------
+/** Returns the upper bound in milliseconds of the bucket containing the
+ *  given percentile (0-100). */
+uint64_t LobbyProfiler::Histogram::getPercentileMs(float percentile) const
+{
+    if (m_count == 0)
+        return 0;
+    const uint64_t target = (uint64_t)((float)m_count * percentile / 100.0f);
+    uint64_t accumulated = 0;
+    for (unsigned i = 0; i < BUCKETS; i++)
+    {
+        accumulated += m_buckets[i];
+        if (accumulated > target || accumulated == m_count)
+            return 1ull << i;
+    }
+    return 1ull << (BUCKETS - 1);
+}   // getPercentileMs
+
+// ============================================================================
+LobbyProfiler::LobbyProfiler()
+{
+    m_current_state = NULL;
+    m_state_start_us = 0;
+}   // LobbyProfiler
+
+// ----------------------------------------------------------------------------
+/** Called regularly with the name of the current lobby state, when it
+ *  differs from the previous one the time spent in the previous state is
+ *  recorded. The name must be a string literal.
+ */
+void LobbyProfiler::updateState(const char* name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_current_state == name)
+        return;
+    const uint64_t now = StkTime::getMonoTimeUs();
+    if (m_current_state)
+        m_states[m_current_state].add(now - m_state_start_us);
+    m_current_state = name;
+    m_state_start_us = now;
+}   // updateState
+
+// ----------------------------------------------------------------------------
+void LobbyProfiler::addHandlerTime(const char* name, uint64_t us)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_handlers[name].add(us);
+}   // addHandlerTime
+
+// ----------------------------------------------------------------------------
+void LobbyProfiler::dumpHistograms(std::string* out, const char* title,
+                                   const std::map<std::string, Histogram>& h)
+{
+    *out += title;
+    *out += "\n";
+    char line[256];
+    for (auto& p : h)
+    {
+        const Histogram& hist = p.second;
+        snprintf(line, 256, "  %s: count %d, avg %.3f ms, p50 <%d ms, "
+            "p95 <%d ms, max %.3f ms\n", p.first.c_str(), (int)hist.m_count,
+            (float)hist.m_total_us / (float)hist.m_count / 1000.0f,
+            (int)hist.getPercentileMs(50.0f),
+            (int)hist.getPercentileMs(95.0f),
+            (float)hist.m_max_us / 1000.0f);
+        *out += line;
+    }
+}   // dumpHistograms
+
+// ----------------------------------------------------------------------------
+/** Returns a human readable summary of all histograms. */
+std::string LobbyProfiler::dump() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::string out;
+    dumpHistograms(&out, "Time spent in lobby states:", m_states);
+    if (m_current_state)
+    {
+        char line[256];
+        snprintf(line, 256, "  (now in %s for %.3f ms)\n", m_current_state,
+            (float)(StkTime::getMonoTimeUs() - m_state_start_us) / 1000.0f);
+        out += line;
+    }
+    dumpHistograms(&out, "Time used by lobby event handlers:", m_handlers);
+    return out;
+}   // dump
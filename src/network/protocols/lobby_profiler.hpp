@@ -0,0 +1,117 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_LOBBY_PROFILER_HPP
+#define HEADER_LOBBY_PROFILER_HPP
+
+#include "utils/no_copy.hpp"
+#include "utils/time.hpp"
+#include "utils/types.hpp"
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <string>
+
+/** \ingroup network */
+
+// ============================================================================
+/*! \class LobbyProfiler
+ *  \brief Collects latency histograms of the server lobby, including the time
+ *  spent in each state of the lobby state machine and the time used by each
+ *  event handler, so slow steps between races can be found. It can be used
+ *  from the main and lobby thread at the same time.
+ */
+class LobbyProfiler : public NoCopy
+{
+public:
+    /** Number of histogram buckets, bucket i counts times below 2^i ms
+     *  (the last one counts everything else). */
+    static const unsigned BUCKETS = 18;
+
+    struct Histogram
+    {
+        uint64_t m_count = 0;
+        uint64_t m_total_us = 0;
+        uint64_t m_max_us = 0;
+        std::array<uint64_t, BUCKETS> m_buckets = {};
+        // --------------------------------------------------------------------
+        void add(uint64_t us);
+        // --------------------------------------------------------------------
+        uint64_t getPercentileMs(float percentile) const;
+    };
+
+    // ========================================================================
+    /** Records the time between its creation and destruction as event
+     *  handler time. Nothing is recorded if no name is set, so a timer can
+     *  be started before it is known which handler (if any) will run. */
+    class ScopedTimer : public NoCopy
+    {
+    private:
+        LobbyProfiler* m_profiler;
+        const char* m_name;
+        uint64_t m_start_us;
+    public:
+        ScopedTimer(LobbyProfiler* profiler, const char* name = NULL)
+            : m_profiler(profiler), m_name(name)
+        {
+            m_start_us = StkTime::getMonoTimeUs();
+        }
+        // --------------------------------------------------------------------
+        ~ScopedTimer()
+        {
+            if (m_name)
+            {
+                m_profiler->addHandlerTime(m_name,
+                    StkTime::getMonoTimeUs() - m_start_us);
+            }
+        }
+        // --------------------------------------------------------------------
+        /** Sets the name of the handler, it must be a string literal. */
+        void setName(const char* name)                     { m_name = name; }
+    };
+
+private:
+    mutable std::mutex m_mutex;
+
+    std::map<std::string, Histogram> m_states;
+
+    std::map<std::string, Histogram> m_handlers;
+
+    /** Name of the current state, NULL before the first state is set. */
+    const char* m_current_state;
+
+    uint64_t m_state_start_us;
+
+    // ------------------------------------------------------------------------
+    static void dumpHistograms(std::string* out, const char* title,
+                               const std::map<std::string, Histogram>& h);
+
+public:
+    // ------------------------------------------------------------------------
+    LobbyProfiler();
+    // ------------------------------------------------------------------------
+    void updateState(const char* name);
+    // ------------------------------------------------------------------------
+    void addHandlerTime(const char* name, uint64_t us);
+    // ------------------------------------------------------------------------
+    std::string dump() const;
+
+};   // LobbyProfiler
+
+#endif // HEADER_LOBBY_PROFILER_HPP
@@ -52,6 +52,7 @@
 #include "tracks/check_manager.hpp"
 #include "tracks/track.hpp"
 #include "tracks/track_manager.hpp"
+#include "tracks/track_residency_pool.hpp"
 #include "utils/log.hpp"
 #include "utils/random_generator.hpp"
 #include "utils/string_utils.hpp"
@@ -219,6 +220,8 @@ ServerLobby::ServerLobby() : LobbyProtocol()
     m_game_mode.store(ServerConfig::m_server_mode);
     m_default_vote = new PeerVote();
     m_player_reports_table_exists = false;
+    if (m_process_type == PT_MAIN)
+        TrackResidencyPool::create();
     initDatabase();
 }   // ServerLobby
 
@@ -234,6 +237,8 @@ ServerLobby::~ServerLobby()
     }
     delete m_result_ns;
     delete m_items_complete_state;
+    for (LiveJoinAck& ack : m_live_join_acks)
+        delete ack.m_ack;
     if (m_save_server_config)
         ServerConfig::writeServerConfigToDisk();
     delete m_default_vote;
@@ -706,6 +711,7 @@ void ServerLobby::setup()
     updateTracksForMode();
 
     m_server_has_loaded_world.store(false);
+    m_last_voted_track.clear();
 
     // Initialise the data structures to detect if all clients and 
     // the server are ready:
@@ -728,13 +734,30 @@ bool ServerLobby::notifyEvent(Event* event)
     message_type = data.getUInt8();
     Log::info("ServerLobby", "Synchronous message of type %d received.",
               message_type);
+    // Named in each case, so only events reaching a handler are timed
+    LobbyProfiler::ScopedTimer timer(&m_profiler);
     switch (message_type)
     {
-    case LE_RACE_FINISHED_ACK: playerFinishedResult(event);   break;
-    case LE_LIVE_JOIN:         liveJoinRequest(event);        break;
-    case LE_CLIENT_LOADED_WORLD: finishedLoadingLiveJoinClient(event); break;
-    case LE_KART_INFO: handleKartInfo(event); break;
-    case LE_CLIENT_BACK_LOBBY: clientInGameWantsToBackLobby(event); break;
+    case LE_RACE_FINISHED_ACK:
+        timer.setName("playerFinishedResult");
+        playerFinishedResult(event);
+        break;
+    case LE_LIVE_JOIN:
+        timer.setName("liveJoinRequest");
+        liveJoinRequest(event);
+        break;
+    case LE_CLIENT_LOADED_WORLD:
+        timer.setName("finishedLoadingLiveJoinClient");
+        finishedLoadingLiveJoinClient(event);
+        break;
+    case LE_KART_INFO:
+        timer.setName("handleKartInfo");
+        handleKartInfo(event);
+        break;
+    case LE_CLIENT_BACK_LOBBY:
+        timer.setName("clientInGameWantsToBackLobby");
+        clientInGameWantsToBackLobby(event);
+        break;
     default: Log::error("ServerLobby", "Unknown message of type %d - ignored.",
                         message_type);
              break;
@@ -874,35 +897,99 @@ bool ServerLobby::notifyEventAsynchronous(Event* event)
         message_type = data.getUInt8();
         Log::info("ServerLobby", "Message of type %d received.",
                   message_type);
+        // Named in each case, so only events reaching a handler are timed
+        LobbyProfiler::ScopedTimer timer(&m_profiler);
         switch(message_type)
         {
-        case LE_CONNECTION_REQUESTED: connectionRequested(event); break;
-        case LE_KART_SELECTION: kartSelectionRequested(event);    break;
-        case LE_CLIENT_LOADED_WORLD: finishedLoadingWorldClient(event); break;
-        case LE_VOTE: handlePlayerVote(event);                    break;
-        case LE_KICK_HOST: kickHost(event);                       break;
-        case LE_CHANGE_TEAM: changeTeam(event);                   break;
-        case LE_REQUEST_BEGIN: startSelection(event);             break;
-        case LE_CHAT: handleChat(event);                          break;
-        case LE_CONFIG_SERVER: handleServerConfiguration(event);  break;
-        case LE_CHANGE_HANDICAP: changeHandicap(event);           break;
+        case LE_CONNECTION_REQUESTED:
+            timer.setName("connectionRequested");
+            connectionRequested(event);
+            break;
+        case LE_KART_SELECTION:
+            timer.setName("kartSelectionRequested");
+            kartSelectionRequested(event);
+            break;
+        case LE_CLIENT_LOADED_WORLD:
+            timer.setName("finishedLoadingWorldClient");
+            finishedLoadingWorldClient(event);
+            break;
+        case LE_VOTE:
+            timer.setName("handlePlayerVote");
+            handlePlayerVote(event);
+            break;
+        case LE_KICK_HOST:
+            timer.setName("kickHost");
+            kickHost(event);
+            break;
+        case LE_CHANGE_TEAM:
+            timer.setName("changeTeam");
+            changeTeam(event);
+            break;
+        case LE_REQUEST_BEGIN:
+            timer.setName("startSelection");
+            startSelection(event);
+            break;
+        case LE_CHAT:
+            timer.setName("handleChat");
+            handleChat(event);
+            break;
+        case LE_CONFIG_SERVER:
+            timer.setName("handleServerConfiguration");
+            handleServerConfiguration(event);
+            break;
+        case LE_CHANGE_HANDICAP:
+            timer.setName("changeHandicap");
+            changeHandicap(event);
+            break;
         case LE_CLIENT_BACK_LOBBY:
-            clientSelectingAssetsWantsToBackLobby(event);         break;
-        case LE_REPORT_PLAYER: writePlayerReport(event);          break;
+            timer.setName("clientSelectingAssetsWantsToBackLobby");
+            clientSelectingAssetsWantsToBackLobby(event);
+            break;
+        case LE_REPORT_PLAYER:
+            timer.setName("writePlayerReport");
+            writePlayerReport(event);
+            break;
         case LE_ASSETS_UPDATE:
-            handleAssets(event->data(), event->getPeer());        break;
+            timer.setName("handleAssets");
+            handleAssets(event->data(), event->getPeer());
+            break;
         case LE_COMMAND:
-            handleServerCommand(event, event->getPeerSP());       break;
+            timer.setName("handleServerCommand");
+            handleServerCommand(event, event->getPeerSP());
+            break;
         default:                                                  break;
         }   // switch
     } // if (event->getType() == EVENT_TYPE_MESSAGE)
     else if (event->getType() == EVENT_TYPE_DISCONNECTED)
     {
+        LobbyProfiler::ScopedTimer timer(&m_profiler, "clientDisconnected");
         clientDisconnected(event);
     } // if (event->getType() == EVENT_TYPE_DISCONNECTED)
     return true;
 }   // notifyEventAsynchronous
 
+//-----------------------------------------------------------------------------
+/** Returns the name of a lobby state for profiling. */
+const char* ServerLobby::getStateName(ServerState state)
+{
+    switch (state)
+    {
+    case SET_PUBLIC_ADDRESS:        return "SET_PUBLIC_ADDRESS";
+    case REGISTER_SELF_ADDRESS:     return "REGISTER_SELF_ADDRESS";
+    case WAITING_FOR_START_GAME:    return "WAITING_FOR_START_GAME";
+    case SELECTING:                 return "SELECTING";
+    case LOAD_WORLD:                return "LOAD_WORLD";
+    case WAIT_FOR_WORLD_LOADED:     return "WAIT_FOR_WORLD_LOADED";
+    case WAIT_FOR_RACE_STARTED:     return "WAIT_FOR_RACE_STARTED";
+    case RACING:                    return "RACING";
+    case WAIT_FOR_RACE_STOPPED:     return "WAIT_FOR_RACE_STOPPED";
+    case RESULT_DISPLAY:            return "RESULT_DISPLAY";
+    case ERROR_LEAVE:               return "ERROR_LEAVE";
+    case EXITING:                   return "EXITING";
+    }
+    return "UNKNOWN";
+}   // getStateName
+
 //-----------------------------------------------------------------------------
 #ifdef ENABLE_SQLITE3
 /* Every 1 minute STK will poll database:
@@ -1344,6 +1431,8 @@ void ServerLobby::writePlayerReport(Event* event)
 /** Find out the public IP server or poll STK server asynchronously. */
 void ServerLobby::asynchronousUpdate()
 {
+    m_profiler.updateState(getStateName(m_state.load()));
+
     if (m_rs_state.load() == RS_ASYNC_RESET)
     {
         resetVotingTime();
@@ -1531,11 +1620,17 @@ void ServerLobby::asynchronousUpdate()
             return;
         }
 
+        if (TrackResidencyPool::get())
+            updatePreloadTrack();
+
         PeerVote winner_vote;
         m_winner_peer_id = std::numeric_limits<uint32_t>::max();
         bool go_on_race = false;
         if (ServerConfig::m_track_voting)
+        {
+            LobbyProfiler::ScopedTimer timer(&m_profiler, "handleAllVotes");
             go_on_race = handleAllVotes(&winner_vote, &m_winner_peer_id);
+        }
         else if (m_game_setup->isGrandPrixStarted() || isVotingOver())
         {
             winner_vote = *m_default_vote;
@@ -1949,8 +2044,6 @@ void ServerLobby::finishedLoadingLiveJoinClient(Event* event)
         rejectLiveJoin(peer.get(), BLR_NO_GAME_FOR_LIVE_JOIN);
         return;
     }
-    World* w = World::getWorld();
-    assert(w);
 
     uint64_t live_join_start_time = STKHost::get()->getNetworkTimer();
 
@@ -1991,31 +2084,134 @@ void ServerLobby::finishedLoadingLiveJoinClient(Event* event)
         .addUInt8(cc).addUInt64(live_join_start_time)
         .addUInt32(m_last_live_join_util_ticks);
 
+    // The complete state is appended in sendLiveJoinAcks after all events
+    // of this frame, so it includes the karts of all peers joining now
+    m_live_join_acks.push_back({ peer, ns, spectator });
+    peer->updateLastActivity();
+}   // finishedLoadingLiveJoinClient
+
+//-----------------------------------------------------------------------------
+/** Sends the acks of all peers which finished loading for live join in this
+ *  frame. The complete item and world state and the player list don't depend
+ *  on the peer, so they are saved only once and appended to the header of
+ *  each ack. The world state may depend on the client capabilities, so it's
+ *  saved once for each different set of them.
+ */
+void ServerLobby::sendLiveJoinAcks()
+{
+    if (m_live_join_acks.empty())
+        return;
+
+    std::vector<LiveJoinAck> acks;
+    std::swap(acks, m_live_join_acks);
+    if (!worldIsActive())
+    {
+        for (LiveJoinAck& ack : acks)
+        {
+            std::shared_ptr<STKPeer> peer = ack.m_peer.lock();
+            if (peer)
+                rejectLiveJoin(peer.get(), BLR_NO_GAME_FOR_LIVE_JOIN);
+            delete ack.m_ack;
+        }
+        return;
+    }
+
     NetworkItemManager* nim = dynamic_cast<NetworkItemManager*>
         (Track::getCurrentTrack()->getItemManager());
     assert(nim);
-    nim->saveCompleteState(ns);
-    nim->addLiveJoinPeer(peer);
+    BareNetworkString items_state;
+    nim->saveCompleteState(&items_state);
 
-    w->saveCompleteState(ns, peer.get());
+    BareNetworkString players;
     if (RaceManager::get()->supportsLiveJoining())
     {
         // Only needed in non-racing mode as no need players can added after
         // starting of race
-        std::vector<std::shared_ptr<NetworkPlayerProfile> > players =
+        std::vector<std::shared_ptr<NetworkPlayerProfile> > live_players =
             getLivePlayers();
-        encodePlayers(ns, players);
+        encodePlayers(&players, live_players);
     }
 
-    m_peers_ready[peer] = false;
-    peer->setWaitingForGame(false);
-    peer->setSpectator(spectator);
+    std::map<std::set<std::string>, BareNetworkString> states;
+    for (LiveJoinAck& ack : acks)
+    {
+        std::shared_ptr<STKPeer> peer = ack.m_peer.lock();
+        if (!peer)
+        {
+            delete ack.m_ack;
+            continue;
+        }
+        auto it = states.find(peer->getClientCapabilities());
+        if (it == states.end())
+        {
+            it = states.emplace(peer->getClientCapabilities(),
+                BareNetworkString()).first;
+            BareNetworkString& state = it->second;
+            state += items_state;
+            World::getWorld()->saveCompleteState(&state, peer.get());
+            state += players;
+        }
+        *ack.m_ack += it->second;
+        // Item events after the saved state will be sent to the peer
+        nim->addLiveJoinPeer(peer);
+
+        m_peers_ready[peer] = false;
+        peer->setWaitingForGame(false);
+        peer->setSpectator(ack.m_spectator);
 
-    peer->sendPacket(ns, true/*reliable*/);
-    delete ns;
+        peer->sendPacket(ack.m_ack, true/*reliable*/);
+        delete ack.m_ack;
+    }
     updatePlayerList();
-    peer->updateLastActivity();
-}   // finishedLoadingLiveJoinClient
+}   // sendLiveJoinAcks
+
+//-----------------------------------------------------------------------------
+/** Called by the lobby thread while players are voting, finds the currently
+ *  most voted track so its models can be loaded before voting is over.
+ */
+void ServerLobby::updatePreloadTrack()
+{
+    std::map<std::string, unsigned> tracks;
+    std::string top_track;
+    unsigned top_votes = 0;
+    for (auto& p : m_peers_votes)
+    {
+        unsigned votes = ++tracks[p.second.m_track_name];
+        if (votes > top_votes)
+        {
+            top_votes = votes;
+            top_track = p.second.m_track_name;
+        }
+    }
+    if (top_track.empty() || top_track == m_last_voted_track)
+        return;
+    m_last_voted_track = top_track;
+    std::lock_guard<std::mutex> lock(m_preload_track_mutex);
+    m_preload_track = top_track;
+}   // updatePreloadTrack
+
+//-----------------------------------------------------------------------------
+/** Loads the models of the most voted track in the main thread, as irrlicht
+ *  is not thread-safe. */
+void ServerLobby::preloadTrack()
+{
+    TrackResidencyPool* pool = TrackResidencyPool::get();
+    if (!pool || World::getWorld())
+        return;
+    std::string ident;
+    {
+        std::lock_guard<std::mutex> lock(m_preload_track_mutex);
+        std::swap(ident, m_preload_track);
+    }
+    if (ident.empty())
+        return;
+    Track* t = track_manager->getTrack(ident);
+    if (t)
+    {
+        LobbyProfiler::ScopedTimer timer(&m_profiler, "preloadTrack");
+        pool->preload(t);
+    }
+}   // preloadTrack
 
 //-----------------------------------------------------------------------------
 /** Simple finite state machine.  Once this
@@ -2024,6 +2220,9 @@ void ServerLobby::finishedLoadingLiveJoinClient(Event* event)
  */
 void ServerLobby::update(int ticks)
 {
+    m_profiler.updateState(getStateName(m_state.load()));
+    sendLiveJoinAcks();
+
     World* w = World::getWorld();
     bool world_started = m_state.load() >= WAIT_FOR_WORLD_LOADED &&
         m_state.load() <= RACING && m_server_has_loaded_world.load();
@@ -2172,6 +2371,7 @@ void ServerLobby::update(int ticks)
     case SELECTING:
         // The function playerTrackVote will trigger the next state
         // once all track votes have been received.
+        preloadTrack();
         break;
     case LOAD_WORLD:
         Log::info("ServerLobbyRoom", "Starting the race loading.");
@@ -19,6 +19,7 @@
 #ifndef SERVER_LOBBY_HPP
 #define SERVER_LOBBY_HPP
 
+#include "network/protocols/lobby_profiler.hpp"
 #include "network/protocols/lobby_protocol.hpp"
 #include "utils/cpp2011.hpp"
 #include "utils/time.hpp"
@@ -78,6 +79,13 @@ private:
         std::string m_country_code;
         bool m_tried = false;
     };
+    /* A live join ack waiting for the complete state, see sendLiveJoinAcks */
+    struct LiveJoinAck
+    {
+        std::weak_ptr<STKPeer> m_peer;
+        NetworkString* m_ack;
+        bool m_spectator;
+    };
     bool m_player_reports_table_exists;
 
 #ifdef ENABLE_SQLITE3
@@ -203,9 +211,26 @@ private:
     /* Saved the last game result */
     NetworkString* m_result_ns;
 
+    /* Timing of lobby states and event handlers */
+    LobbyProfiler m_profiler;
+
     /* Used to make sure clients are having same item list at start */
     BareNetworkString* m_items_complete_state;
 
+    /* Acks of the live join peers finished loading in this frame, they are
+     * sent together after all events are handled, so the complete state
+     * is saved only once for all of them (main thread only) */
+    std::vector<LiveJoinAck> m_live_join_acks;
+
+    /* Most voted track found by the lobby thread while players are voting,
+     * its models are preloaded by the main thread (empty if done) */
+    std::string m_preload_track;
+
+    std::mutex m_preload_track_mutex;
+
+    /* Last most voted track, only used in the lobby thread */
+    std::string m_last_voted_track;
+
     std::atomic<uint32_t> m_server_id_online;
 
     std::atomic<uint32_t> m_client_server_host_id;
@@ -248,6 +273,9 @@ private:
     void registerServer();
     void finishedLoadingWorldClient(Event *event);
     void finishedLoadingLiveJoinClient(Event *event);
+    void sendLiveJoinAcks();
+    void updatePreloadTrack();
+    void preloadTrack();
     void kickHost(Event* event);
     void changeTeam(Event* event);
     void handleChat(Event* event);
@@ -356,6 +384,7 @@ private:
     void writePlayerReport(Event* event);
     bool supportsAI();
     void updateAddons();
+    static const char* getStateName(ServerState state);
 public:
              ServerLobby();
     virtual ~ServerLobby();
@@ -392,6 +421,7 @@ public:
     }
     uint32_t getServerIdOnline() const           { return m_server_id_online; }
     void setClientServerHostId(uint32_t id)   { m_client_server_host_id = id; }
+    const LobbyProfiler& getProfiler() const             { return m_profiler; }
 };   // class ServerLobby
 
 #endif // SERVER_LOBBY_HPP
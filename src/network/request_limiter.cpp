@@ -0,0 +1,268 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "network/request_limiter.hpp"
+#include "network/socket_address.hpp"
+#include "utils/time.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+// ----------------------------------------------------------------------------
+/** Constructor.
+ *  \param ip_rate Requests per second allowed from a single IP, 0 to disable.
+ *  \param ip_burst Maximum requests from a single IP allowed at once.
+ *  \param prefix_rate Requests per second allowed from a /24 (IPv4) or /64
+ *         (IPv6) network, 0 to disable.
+ *  \param prefix_burst Maximum requests from a network allowed at once.
+ */
+RequestLimiter::RequestLimiter(float ip_rate, float ip_burst,
+                               float prefix_rate, float prefix_burst)
+              : m_ip_rate(ip_rate), m_ip_burst(std::max(ip_burst, 1.0f)),
+                m_prefix_rate(prefix_rate),
+                m_prefix_burst(std::max(prefix_burst, 1.0f))
+{
+    m_last_cleanup_time = 0;
+    m_accepted.store(0);
+    m_rejected_ip.store(0);
+    m_rejected_prefix.store(0);
+    m_rejected_full.store(0);
+}   // RequestLimiter
+
+// ----------------------------------------------------------------------------
+/** Computes the raw bytes of the address and its network prefix, which are
+ *  used as keys of the buckets. IPv4 mapped IPv6 addresses are treated as
+ *  IPv4 so the same host is limited once no matter which socket is used.
+ */
+void RequestLimiter::getKeys(const SocketAddress& addr, std::string* ip_key,
+                             std::string* prefix_key)
+{
+    if (addr.isIPv6())
+    {
+        const sockaddr_in6* in6 = (const sockaddr_in6*)addr.getSockaddr();
+        const char* bytes = (const char*)in6->sin6_addr.s6_addr;
+        *ip_key = std::string(bytes, 16);
+        *prefix_key = std::string(bytes, 8);
+    }
+    else
+    {
+        const uint32_t ip = addr.getIP();
+        char bytes[4] = { (char)(ip >> 24), (char)(ip >> 16),
+                          (char)(ip >> 8), (char)ip };
+        // Prefix the family so IPv4 and IPv6 keys never collide
+        *ip_key = std::string("4") + std::string(bytes, 4);
+        *prefix_key = std::string("4") + std::string(bytes, 3);
+    }
+}   // getKeys
+
+// ----------------------------------------------------------------------------
+void RequestLimiter::refill(TokenBucket* tb, float rate, float burst,
+                            uint64_t now)
+{
+    if (now > tb->m_last_time)
+    {
+        tb->m_tokens = std::min(burst,
+            tb->m_tokens + (float)(now - tb->m_last_time) / 1000.0f * rate);
+    }
+    tb->m_last_time = now;
+}   // refill
+
+// ----------------------------------------------------------------------------
+/** Returns the refilled bucket of a key, a new one is created if it doesn't
+ *  exist. Returns NULL if there are already MAX_BUCKETS buckets, new sources
+ *  are dropped then until the next cleanup.
+ */
+RequestLimiter::TokenBucket* RequestLimiter::getBucket(
+                                  std::map<std::string, TokenBucket>* buckets,
+                                  const std::string& key, float rate,
+                                  float burst, uint64_t now)
+{
+    auto it = buckets->find(key);
+    if (it == buckets->end())
+    {
+        if (buckets->size() >= MAX_BUCKETS)
+            return NULL;
+        it = buckets->emplace(key, TokenBucket{ burst, now }).first;
+    }
+    refill(&it->second, rate, burst, now);
+    return &it->second;
+}   // getBucket
+
+// ----------------------------------------------------------------------------
+/** Removes buckets which are full again, as they are equivalent to a newly
+ *  created one. Done at most every 10 seconds so a flood of spoofed
+ *  addresses cannot grow the maps without bound for long.
+ */
+void RequestLimiter::cleanup(uint64_t now)
+{
+    if (now < m_last_cleanup_time + 10000)
+        return;
+    m_last_cleanup_time = now;
+    for (auto it = m_ip_buckets.begin(); it != m_ip_buckets.end();)
+    {
+        refill(&it->second, m_ip_rate, m_ip_burst, now);
+        if (it->second.m_tokens >= m_ip_burst)
+            it = m_ip_buckets.erase(it);
+        else
+            it++;
+    }
+    for (auto it = m_prefix_buckets.begin(); it != m_prefix_buckets.end();)
+    {
+        refill(&it->second, m_prefix_rate, m_prefix_burst, now);
+        if (it->second.m_tokens >= m_prefix_burst)
+            it = m_prefix_buckets.erase(it);
+        else
+            it++;
+    }
+}   // cleanup
+
+// ----------------------------------------------------------------------------
+/** Returns true if a request from this address should be handled, false if
+ *  it should be dropped without any further processing.
+ */
+bool RequestLimiter::allow(const SocketAddress& addr)
+{
+    return allow(addr, StkTime::getMonoTimeMs());
+}   // allow
+
+// ----------------------------------------------------------------------------
+bool RequestLimiter::allow(const SocketAddress& addr, uint64_t now)
+{
+    // LAN players (and LAN server discovery) are never limited
+    if (!isEnabled() || addr.isLAN() || addr.isLoopback())
+    {
+        m_accepted++;
+        return true;
+    }
+
+    std::string ip_key, prefix_key;
+    getKeys(addr, &ip_key, &prefix_key);
+
+    std::lock_guard<std::mutex> lock(m_buckets_mutex);
+    cleanup(now);
+
+    TokenBucket* ip_tb = NULL;
+    if (m_ip_rate > 0.0f)
+    {
+        ip_tb = getBucket(&m_ip_buckets, ip_key, m_ip_rate, m_ip_burst, now);
+        if (!ip_tb)
+        {
+            m_rejected_full++;
+            return false;
+        }
+        if (ip_tb->m_tokens < 1.0f)
+        {
+            m_rejected_ip++;
+            return false;
+        }
+    }
+
+    // Only consume tokens after both buckets allow it, so a rejected request
+    // by the network prefix doesn't penalize the host further
+    if (m_prefix_rate > 0.0f)
+    {
+        TokenBucket* prefix_tb = getBucket(&m_prefix_buckets, prefix_key,
+            m_prefix_rate, m_prefix_burst, now);
+        if (!prefix_tb)
+        {
+            m_rejected_full++;
+            return false;
+        }
+        if (prefix_tb->m_tokens < 1.0f)
+        {
+            m_rejected_prefix++;
+            return false;
+        }
+        prefix_tb->m_tokens -= 1.0f;
+    }
+    if (ip_tb)
+        ip_tb->m_tokens -= 1.0f;
+    m_accepted++;
+    return true;
+}   // allow
+
+// ----------------------------------------------------------------------------
+/** Unit testing, checks burst, refill and prefix grouping of requests. */
+void RequestLimiter::unitTesting()
+{
+    RequestLimiter rl(1.0f, 3.0f, 2.0f, 5.0f);
+    SocketAddress a1("93.1.2.3");
+    SocketAddress a2("93.1.2.4");
+    SocketAddress a3("93.1.3.3");
+    SocketAddress a4("::ffff:93.1.2.3");
+
+    // Burst of 3 for a single IP
+    assert(rl.allow(a1, 1000));
+    assert(rl.allow(a1, 1000));
+    assert(rl.allow(a1, 1000));
+    assert(!rl.allow(a1, 1000));
+    assert(rl.getRejectedByIP() == 1);
+    // IPv4 mapped address is the same host
+    assert(!rl.allow(a4, 1000));
+    assert(rl.getRejectedByIP() == 2);
+
+    // Same /24 network shares the prefix bucket of 5
+    assert(rl.allow(a2, 1000));
+    assert(rl.allow(a2, 1000));
+    assert(!rl.allow(a2, 1000));
+    assert(rl.getRejectedByPrefix() == 1);
+    // Other network is not affected
+    assert(rl.allow(a3, 1000));
+
+    // One token per second for the host, two for the network
+    assert(rl.allow(a1, 2000));
+    assert(!rl.allow(a1, 2000));
+    assert(rl.getAccepted() == 7);
+
+    SocketAddress b1("2001:db8:1:2::1");
+    SocketAddress b2("2001:db8:1:2::2");
+    SocketAddress b3("2001:db8:1:3::1");
+    for (int i = 0; i < 3; i++)
+        assert(rl.allow(b1, 5000));
+    assert(!rl.allow(b1, 5000));
+    assert(rl.allow(b2, 5000));
+    assert(rl.allow(b2, 5000));
+    assert(!rl.allow(b2, 5000));
+    assert(rl.allow(b3, 5000));
+
+    // Full buckets are removed after cleanup
+    assert(rl.allow(b1, 60000));
+    assert(rl.m_ip_buckets.size() == 1);
+
+    RequestLimiter disabled(0.0f, 0.0f, 0.0f, 0.0f);
+    for (int i = 0; i < 100; i++)
+        assert(disabled.allow(a1, 1000));
+
+    SocketAddress lan("192.168.0.2");
+    for (int i = 0; i < 100; i++)
+        assert(rl.allow(lan, 60000));
+
+    // New sources are dropped when the buckets are full, until cleanup
+    RequestLimiter full(1.0f, 3.0f, 0.0f, 0.0f);
+    for (unsigned i = 0; i < MAX_BUCKETS; i++)
+    {
+        SocketAddress addr(0x5d000000 + i, 0);
+        assert(full.allow(addr, 1000));
+    }
+    assert(full.m_ip_buckets.size() == MAX_BUCKETS);
+    assert(full.allow(SocketAddress(0x5d000000, 0), 1000));
+    assert(!full.allow(SocketAddress(0x5e000000, 0), 1000));
+    assert(full.getRejectedByFull() == 1);
+    assert(full.allow(SocketAddress(0x5e000000, 0), 20000));
+    assert(full.m_ip_buckets.size() == 1);
+}   // unitTesting
@@ -0,0 +1,110 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_REQUEST_LIMITER_HPP
+#define HEADER_REQUEST_LIMITER_HPP
+
+#include "utils/types.hpp"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+
+class SocketAddress;
+
+/** \ingroup network */
+
+// ============================================================================
+/*! \class RequestLimiter
+ *  \brief Token bucket admission control for unauthenticated requests
+ *  (server queries on the direct socket and new enet connections). Each
+ *  request consumes a token from the bucket of its source IP and of its
+ *  network prefix (/24 for IPv4, /64 for IPv6), so a flood from one host or
+ *  a block of addresses is dropped before any expensive processing.
+ */
+class RequestLimiter
+{
+private:
+    struct TokenBucket
+    {
+        float m_tokens;
+        uint64_t m_last_time;
+    };
+
+    /** Maximum buckets in each map, so a flood of spoofed addresses cannot
+     *  grow them without bound between cleanups. */
+    static const size_t MAX_BUCKETS = 10000;
+
+    std::mutex m_buckets_mutex;
+
+    std::map<std::string, TokenBucket> m_ip_buckets;
+
+    std::map<std::string, TokenBucket> m_prefix_buckets;
+
+    /** Tokens refilled per second and maximum tokens for each bucket. */
+    float m_ip_rate, m_ip_burst, m_prefix_rate, m_prefix_burst;
+
+    uint64_t m_last_cleanup_time;
+
+    std::atomic<uint64_t> m_accepted;
+
+    std::atomic<uint64_t> m_rejected_ip;
+
+    std::atomic<uint64_t> m_rejected_prefix;
+
+    std::atomic<uint64_t> m_rejected_full;
+
+    // ------------------------------------------------------------------------
+    static void getKeys(const SocketAddress& addr, std::string* ip_key,
+                        std::string* prefix_key);
+    // ------------------------------------------------------------------------
+    static void refill(TokenBucket* tb, float rate, float burst,
+                       uint64_t now);
+    // ------------------------------------------------------------------------
+    static TokenBucket* getBucket(std::map<std::string, TokenBucket>* buckets,
+                                  const std::string& key, float rate,
+                                  float burst, uint64_t now);
+    // ------------------------------------------------------------------------
+    void cleanup(uint64_t now);
+
+public:
+    static void unitTesting();
+    // ------------------------------------------------------------------------
+    RequestLimiter(float ip_rate, float ip_burst, float prefix_rate,
+                   float prefix_burst);
+    // ------------------------------------------------------------------------
+    bool allow(const SocketAddress& addr);
+    // ------------------------------------------------------------------------
+    bool allow(const SocketAddress& addr, uint64_t now);
+    // ------------------------------------------------------------------------
+    /** Returns true if limiting is enabled, a rate of 0 disables it. */
+    bool isEnabled() const
+                        { return m_ip_rate > 0.0f || m_prefix_rate > 0.0f; }
+    // ------------------------------------------------------------------------
+    uint64_t getAccepted() const                  { return m_accepted.load(); }
+    // ------------------------------------------------------------------------
+    uint64_t getRejectedByIP() const           { return m_rejected_ip.load(); }
+    // ------------------------------------------------------------------------
+    uint64_t getRejectedByPrefix() const   { return m_rejected_prefix.load(); }
+    // ------------------------------------------------------------------------
+    uint64_t getRejectedByFull() const       { return m_rejected_full.load(); }
+
+};   // RequestLimiter
+
+#endif // HEADER_REQUEST_LIMITER_HPP
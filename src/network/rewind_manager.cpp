@@ -18,6 +18,7 @@
 
 #include "network/rewind_manager.hpp"
 
+#include "config/user_config.hpp"
 #include "graphics/irr_driver.hpp"
 #include "modes/world.hpp"
 #include "network/network_config.hpp"
@@ -26,6 +27,8 @@
 #include "network/rewinder.hpp"
 #include "network/rewind_info.hpp"
 #include "network/smooth_network_body.hpp"
+#include "network/stk_host.hpp"
+#include "network/stk_peer.hpp"
 #include "physics/physics.hpp"
 #include "race/history.hpp"
 #include "tracks/check_manager.hpp"
@@ -33,6 +36,7 @@
 #include "tracks/track_object_manager.hpp"
 #include "utils/log.hpp"
 #include "utils/profiler.hpp"
+#include "utils/time.hpp"
 
 #include <algorithm>
 
@@ -63,6 +67,9 @@ void RewindManager::destroy()
  */
 RewindManager::RewindManager()
 {
+    m_replay_time    = 0.0;
+    m_replayed_ticks = 0;
+    m_num_rewinds    = 0;
     reset();
 }   // RewindManager
 
@@ -72,6 +79,14 @@ RewindManager::RewindManager()
  */
 RewindManager::~RewindManager()
 {
+    if (m_replayed_ticks > 0)
+    {
+        Log::info("RewindManager", "Replayed %d ticks in %d rewinds, "
+            "average %f ms per tick using %s ticks.", m_replayed_ticks,
+            m_num_rewinds, m_replay_time * 1000.0 / m_replayed_ticks,
+            UserConfigParams::m_full_tick_replay ? "full" :
+            "simulation-only");
+    }
     for (RewindInfoEventFunction* rief : m_pending_rief)
         delete rief;
     m_pending_rief.clear();
@@ -83,6 +98,7 @@ RewindManager::~RewindManager()
 void RewindManager::reset()
 {
     m_is_rewinding = false;
+    m_send_sleep_state = false;
     m_not_rewound_ticks.store(0);
     m_overall_state_size = 0;
     m_state_frequency = stk_config->getPhysicsFPS() /
@@ -160,6 +176,19 @@ void RewindManager::saveState()
     m_overall_state_size = 0;
     std::vector<std::string> rewinder_using;
 
+    // Older clients can't read the sleeping flag of physical objects
+    m_send_sleep_state = true;
+    for (auto& peer : STKHost::get()->getPeers())
+    {
+        if (peer->isValidated() && !peer->isWaitingForGame() &&
+            peer->getClientCapabilities().find("physics_sleep") ==
+            peer->getClientCapabilities().end())
+        {
+            m_send_sleep_state = false;
+            break;
+        }
+    }
+
     for (auto& p : m_all_rewinder)
     {
         // TODO: check if it's worth passing in a sufficiently large buffer from
@@ -376,7 +405,11 @@ void RewindManager::rewindTo(int rewind_ticks, int now_ticks,
         world->setTicksForRewind(exact_rewind_ticks);
     }
 
-    // Now go forward through the list of rewind infos till we reach 'now':
+    // Now go forward through the list of rewind infos till we reach 'now'.
+    // The replayed ticks are not shown, so only the simulation is updated.
+    const double replay_start = StkTime::getRealTime();
+    const int replay_start_ticks = world->getTicksSinceStart();
+    world->setSimulationOnly(!UserConfigParams::m_full_tick_replay);
     while (world->getTicksSinceStart() < now_ticks)
     { 
         m_rewind_queue.replayAllEvents(world->getTicksSinceStart());
@@ -391,6 +424,13 @@ void RewindManager::rewindTo(int rewind_ticks, int now_ticks,
         world->updateTime(1);
 
     }   // while (world->getTicks() < current_ticks)
+    world->setSimulationOnly(false);
+    if (!fast_forward)
+    {
+        m_replay_time += StkTime::getRealTime() - replay_start;
+        m_replayed_ticks += world->getTicksSinceStart() - replay_start_ticks;
+        m_num_rewinds++;
+    }
 
     // Now compute the errors which need to be visually smoothed
     for (auto& p : m_all_rewinder)
@@ -105,6 +105,10 @@ private:
     /** Indicates if currently a rewind is happening. */
     bool m_is_rewinding;
 
+    /** True if all clients in game can handle the sleeping flag of physical
+     *  objects, updated by the server each time a state is saved. */
+    bool m_send_sleep_state;
+
     /** How much time between consecutive state saves. */
     int m_state_frequency;
 
@@ -113,6 +117,15 @@ private:
      *  rewinds. */
     std::atomic<int> m_not_rewound_ticks;
 
+    /** Total time used to replay ticks in rewinds (in seconds). */
+    double m_replay_time;
+
+    /** Total number of ticks replayed in rewinds. */
+    int m_replayed_ticks;
+
+    /** Number of rewinds, for the statistics printed at the end. */
+    int m_num_rewinds;
+
     std::vector<RewindInfoEventFunction*> m_pending_rief;
 
     RewindManager();
@@ -182,6 +195,10 @@ public:
     // ------------------------------------------------------------------------
     /** Returns true if currently a rewind is happening. */
     bool isRewinding() const { return m_is_rewinding; }
+    // ------------------------------------------------------------------------
+    /** Returns true if the server can add the sleeping flag to the state of
+     *  physical objects. */
+    bool sendSleepState() const { return m_send_sleep_state; }
 
     // ------------------------------------------------------------------------
     int getNotRewoundWorldTicks() const
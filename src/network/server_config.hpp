@@ -172,6 +172,28 @@ namespace ServerConfig
         "STK will use the stk-addons server to share AES key between the client "
         "and server."));
 
+    SERVER_CFG_PREFIX FloatServerConfigParam m_request_rate_per_ip
+        SERVER_CFG_DEFAULT(FloatServerConfigParam(0.0f, "request-rate-per-ip",
+        "Maximum number of server queries and new connections per second "
+        "handled from a single IP address, further requests are dropped. "
+        "LAN addresses are never limited, 0 (default) to disable."));
+
+    SERVER_CFG_PREFIX FloatServerConfigParam m_request_burst_per_ip
+        SERVER_CFG_DEFAULT(FloatServerConfigParam(10.0f,
+        "request-burst-per-ip", "Maximum number of requests handled at once "
+        "from a single IP address before request-rate-per-ip applies."));
+
+    SERVER_CFG_PREFIX FloatServerConfigParam m_request_rate_per_prefix
+        SERVER_CFG_DEFAULT(FloatServerConfigParam(0.0f,
+        "request-rate-per-prefix", "Same as request-rate-per-ip, but for all "
+        "addresses in a /24 IPv4 or /64 IPv6 network, 0 (default) to "
+        "disable."));
+
+    SERVER_CFG_PREFIX FloatServerConfigParam m_request_burst_per_prefix
+        SERVER_CFG_DEFAULT(FloatServerConfigParam(40.0f,
+        "request-burst-per-prefix", "Maximum number of requests handled at "
+        "once from a /24 IPv4 or /64 IPv6 network."));
+
     SERVER_CFG_PREFIX BoolServerConfigParam m_validating_player
         SERVER_CFG_DEFAULT(BoolServerConfigParam(true, "validating-player",
         "By default WAN server will always validate player and LAN will not, "
@@ -266,6 +288,35 @@ namespace ServerConfig
         "available for players to choose, and official-karts-threshold will "
         "be made 1.0."));
 
+    SERVER_CFG_PREFIX IntServerConfigParam m_track_residency_pool_size
+        SERVER_CFG_DEFAULT(IntServerConfigParam(0,
+        "track-residency-pool-size", "Number of recently played tracks whose "
+        "models are kept in memory (only without graphics), so the next race "
+        "on them starts faster. The most voted track is also loaded in "
+        "advance while players are voting. 0 to disable."));
+
+    SERVER_CFG_PREFIX IntServerConfigParam m_physics_threads
+        SERVER_CFG_DEFAULT(IntServerConfigParam(0,
+        "physics-threads", "Number of threads used to solve independent "
+        "groups of colliding objects in the physics, useful for servers with "
+        "many players. 0 or 1 to solve them in the main thread."));
+
+    SERVER_CFG_PREFIX BoolServerConfigParam m_physics_deterministic
+        SERVER_CFG_DEFAULT(BoolServerConfigParam(true,
+        "physics-deterministic", "If true, each group of colliding objects "
+        "is solved on its own with a reset random seed of the constraint "
+        "solver, both in the physics threads and in the main thread, so the "
+        "physics results on the server don't depend on physics-threads. "
+        "The seed is only used if solver-mode in stk_config.xml randomizes "
+        "the order of constraints. Clients are not affected."));
+
+    SERVER_CFG_PREFIX BoolServerConfigParam m_compact_arena_distances
+        SERVER_CFG_DEFAULT(BoolServerConfigParam(false,
+        "compact-arena-distances", "If true, the distances between all nodes "
+        "of battle and soccer arenas are stored as 16 bit values instead of "
+        "floats, which saves memory on servers hosting many arenas. The "
+        "distances used by the AI are then accurate to a few millimeters."));
+
     SERVER_CFG_PREFIX FloatServerConfigParam m_flag_return_timeout
         SERVER_CFG_DEFAULT(FloatServerConfigParam(20.0f, "flag-return-timeout",
         "Time in seconds when a flag is dropped a by player in CTF "
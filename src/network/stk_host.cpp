@@ -32,6 +32,7 @@
 #include "network/protocols/connect_to_peer.hpp"
 #include "network/protocols/server_lobby.hpp"
 #include "network/protocol_manager.hpp"
+#include "network/request_limiter.hpp"
 #include "network/server_config.hpp"
 #include "network/child_loop.hpp"
 #include "network/stk_ipv6.hpp"
@@ -286,6 +287,11 @@ STKHost::STKHost(bool server)
         m_network = new Network(peer_count,
             /*channel_limit*/EVENT_CHANNEL_COUNT, /*max_in_bandwidth*/0,
             /*max_out_bandwidth*/ 0, &addr, true/*change_port_if_bound*/);
+        m_request_limiter.reset(new RequestLimiter(
+            ServerConfig::m_request_rate_per_ip,
+            ServerConfig::m_request_burst_per_ip,
+            ServerConfig::m_request_rate_per_prefix,
+            ServerConfig::m_request_burst_per_prefix));
     }
     else
     {
@@ -1076,6 +1082,15 @@ void STKHost::mainLoop(ProcessType pt)
             Event* stk_event = NULL;
             if (event.type == ENET_EVENT_TYPE_CONNECT)
             {
+                // Each join is only charged here, reset flooding peers before
+                // any stk peer is created, so no protocol or crypto work is
+                // done for them
+                if (is_server && !m_request_limiter->allow(
+                    SocketAddress(event.peer->address)))
+                {
+                    enet_peer_reset(event.peer);
+                    continue;
+                }
                 // ++m_next_unique_host_id for unique host id for database
                 auto stk_peer = std::make_shared<STKPeer>
                     (event.peer, this, ++m_next_unique_host_id);
@@ -1246,6 +1261,10 @@ void STKHost::handleDirectSocketRequest(Network* direct_socket,
     BareNetworkString message(buffer, len);
     std::string command;
     message.decodeString(&command);
+    // Port detection is a step of joining by address, which is charged when
+    // its connection is made, drop other flooding requests before answering
+    if (command != "stk-server-port" && !m_request_limiter->allow(sender))
+        return;
     const std::string connection_cmd = std::string("connection-request") +
         StringUtils::toString(getPrivatePort());
 
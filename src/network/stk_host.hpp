@@ -54,6 +54,7 @@ class Network;
 class NetworkPlayerProfile;
 class NetworkString;
 class NetworkTimerSynchronizer;
+class RequestLimiter;
 class Server;
 class ServerLobby;
 class ChildLoop;
@@ -157,6 +158,9 @@ private:
 
     std::unique_ptr<NetworkTimerSynchronizer> m_nts;
 
+    /** Admission control of unauthenticated requests in server. */
+    std::unique_ptr<RequestLimiter> m_request_limiter;
+
     // ------------------------------------------------------------------------
     STKHost(bool server);
     // ------------------------------------------------------------------------
@@ -375,6 +379,10 @@ public:
     /* Return download speed in bytes per second. */
     unsigned getDownloadSpeed() const       { return m_download_speed.load(); }
     // ------------------------------------------------------------------------
+    /* Return the request limiter in server, NULL in client. */
+    RequestLimiter* getRequestLimiter() const
+                                           { return m_request_limiter.get(); }
+    // ------------------------------------------------------------------------
     void updatePlayers(unsigned* ingame = NULL,
                        unsigned* waiting = NULL,
                        unsigned* total = NULL);
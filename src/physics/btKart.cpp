@@ -33,7 +33,7 @@
 #define ROLLING_INFLUENCE_FIX
 
 // ============================================================================
-btKart::btKart(btRigidBody* chassis, btVehicleRaycaster* raycaster,
+btKart::btKart(btRigidBody* chassis, btKartRaycaster* raycaster,
                Kart *kart)
       : m_vehicleRaycaster(raycaster), m_fixed_body(0, 0, 0)
 {
@@ -223,6 +223,30 @@ void btKart::updateAllWheelTransformsWS()
 
     m_num_wheels_on_ground       = 0;
     m_visual_wheels_touch_ground = true;
+
+    // All wheel rays (including the shorter ones below) are inside this
+    // box, so the track triangles they can hit are only collected once.
+    btVector3 aabb_min( BT_LARGE_FLOAT,  BT_LARGE_FLOAT,  BT_LARGE_FLOAT);
+    btVector3 aabb_max(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+    for (int i=0;i<m_wheelInfo.size();i++)
+    {
+        const btWheelInfo &wheel = m_wheelInfo[i];
+        btVector3 ray = chassisTrans.getBasis() * wheel.m_wheelDirectionCS
+                      * (wheel.getSuspensionRestLength()
+                         + wheel.m_maxSuspensionTravel + 0.5f);
+        for (float fraction : { 1.0f, 0.95f })
+        {
+            btVector3 from = chassisTrans(wheel.m_chassisConnectionPointCS
+                                          * fraction);
+            aabb_min.setMin(from);
+            aabb_max.setMax(from);
+            aabb_min.setMin(from + ray);
+            aabb_max.setMax(from + ray);
+        }
+    }
+    btVector3 margin(0.1f, 0.1f, 0.1f);
+    m_vehicleRaycaster->beginBatch(aabb_min - margin, aabb_max + margin);
+
     for (int i=0;i<m_wheelInfo.size();i++)
     {
         rayCast( i);
@@ -239,6 +263,7 @@ void btKart::updateAllWheelTransformsWS()
                 m_num_wheels_on_ground++;
         }
     }
+    m_vehicleRaycaster->endBatch();
 }   // updateAllWheelTransformsWS
 
 // ----------------------------------------------------------------------------
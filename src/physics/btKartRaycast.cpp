@@ -13,54 +13,180 @@
 #include "btKartRaycast.hpp"
 
 #include "BulletCollision/CollisionDispatch/btCollisionWorld.h"
+#include "BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h"
+#include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletDynamics/Dynamics/btDynamicsWorld.h"
 
 #include "modes/world.hpp"
 #include "physics/triangle_mesh.hpp"
 #include "tracks/track.hpp"
 
-void* btKartRaycaster::castRay(const btVector3& from, const btVector3& to,
-                               btVehicleRaycasterResult& result)
+namespace
+{
+// ============================================================================
+class ClosestWithNormal : public btCollisionWorld::ClosestRayResultCallback
+{
+private:
+    int m_triangle_index;
+    /** An object not to test, since it is tested separately. */
+    const btCollisionObject* m_excluded;
+public:
+    /** Constructor, initialises the triangle index. */
+    ClosestWithNormal(const btVector3 &from,
+                      const btVector3 &to,
+                      const btCollisionObject* excluded)
+                      : btCollisionWorld::ClosestRayResultCallback(from,to)
+    {
+        m_triangle_index = -1;
+        m_excluded = excluded;
+    }   // CloestWithNormal
+    // ------------------------------------------------------------------------
+    virtual bool needsCollision(btBroadphaseProxy* proxy0) const
+    {
+        if (m_excluded && proxy0->m_clientObject == m_excluded)
+            return false;
+        return btCollisionWorld::ClosestRayResultCallback
+            ::needsCollision(proxy0);
+    }   // needsCollision
+    // ------------------------------------------------------------------------
+    /** Stores the index of the triangle hit. */
+    virtual    btScalar addSingleResult(btCollisionWorld::LocalRayResult& rayResult,
+                                     bool normalInWorldSpace)
+    {
+        // We don't always get a triangle index, sometimes (e.g. ray hits
+        // other kart) we get shapePart=-1, or no localShapeInfo at all
+        if(rayResult.m_localShapeInfo &&
+            rayResult.m_localShapeInfo->m_shapePart>-1)
+            m_triangle_index = rayResult.m_localShapeInfo->m_triangleIndex;
+        return
+            btCollisionWorld::ClosestRayResultCallback::addSingleResult(rayResult,
+            normalInWorldSpace);
+    }
+    // ------------------------------------------------------------------------
+    /** Returns the index of the triangle which was hit, or -1 if
+     *  no triangle was hit. */
+    int getTriangleIndex() const { return m_triangle_index; }
+
+};   // CloestWithNormal
+
+// ============================================================================
+/** Reports hits of the triangles of a batch the same way bullet does it for
+ *  a triangle mesh in btCollisionWorld::rayTestSingle. */
+class BatchTriangleRaycast : public btTriangleRaycastCallback
+{
+private:
+    btCollisionWorld::RayResultCallback* m_result_callback;
+    btCollisionObject* m_object;
+public:
+    BatchTriangleRaycast(const btVector3& from, const btVector3& to,
+                         btCollisionWorld::RayResultCallback* result_callback,
+                         btCollisionObject* object)
+        : btTriangleRaycastCallback(from, to, result_callback->m_flags),
+          m_result_callback(result_callback), m_object(object)
+    {
+        m_hitFraction = result_callback->m_closestHitFraction;
+    }
+    // ------------------------------------------------------------------------
+    virtual btScalar reportHit(const btVector3& hitNormalLocal,
+                               btScalar hitFraction, int partId,
+                               int triangleIndex)
+    {
+        btCollisionWorld::LocalShapeInfo shape_info;
+        shape_info.m_shapePart = partId;
+        shape_info.m_triangleIndex = triangleIndex;
+        btVector3 hit_normal_world =
+            m_object->getWorldTransform().getBasis() * hitNormalLocal;
+        btCollisionWorld::LocalRayResult ray_result(m_object, &shape_info,
+            hit_normal_world, hitFraction);
+        return m_result_callback->addSingleResult(ray_result,
+                                                  /*normalInWorldSpace*/true);
+    }
+};   // BatchTriangleRaycast
+
+}   // namespace
+
+// ----------------------------------------------------------------------------
+/** Starts a batch of raycasts inside the given area (e.g. all wheel rays of a
+ *  kart in one physics step): the triangles of the track in this area are
+ *  collected once, and the rays test only these triangles instead of each
+ *  traversing the bvh of the whole track.
+ */
+void btKartRaycaster::beginBatch(const btVector3& aabb_min,
+                                 const btVector3& aabb_max)
 {
     // ========================================================================
-    class ClosestWithNormal : public btCollisionWorld::ClosestRayResultCallback
+    class Collector : public btTriangleCallback
     {
-    private:
-        int m_triangle_index;
     public:
-        /** Constructor, initialises the triangle index. */
-        ClosestWithNormal(const btVector3 &from,
-                          const btVector3 &to)
-                          : btCollisionWorld::ClosestRayResultCallback(from,to)
-        {
-            m_triangle_index = -1;
-        }   // CloestWithNormal
-        // --------------------------------------------------------------------
-        /** Stores the index of the triangle hit. */
-        virtual    btScalar addSingleResult(btCollisionWorld::LocalRayResult& rayResult,
-                                         bool normalInWorldSpace)
+        btAlignedObjectArray<BatchTriangle>* m_triangles;
+        virtual void processTriangle(btVector3* triangle, int partId,
+                                     int triangleIndex)
         {
-            // We don't always get a triangle index, sometimes (e.g. ray hits
-            // other kart) we get shapePart=-1, or no localShapeInfo at all
-            if(rayResult.m_localShapeInfo &&
-                rayResult.m_localShapeInfo->m_shapePart>-1)
-                m_triangle_index = rayResult.m_localShapeInfo->m_triangleIndex;
-            return
-                btCollisionWorld::ClosestRayResultCallback::addSingleResult(rayResult,
-                normalInWorldSpace);
+            BatchTriangle& t = m_triangles->expandNonInitializing();
+            t.m_vertices[0] = triangle[0];
+            t.m_vertices[1] = triangle[1];
+            t.m_vertices[2] = triangle[2];
+            t.m_part = partId;
+            t.m_index = triangleIndex;
         }
-        // --------------------------------------------------------------------
-        /** Returns the index of the triangle which was hit, or -1 if
-         *  no triangle was hit. */
-        int getTriangleIndex() const { return m_triangle_index; }
-
-    };   // CloestWithNormal
+    };   // Collector
     // ========================================================================
 
-    ClosestWithNormal rayCallback(from,to);
+    m_batch_triangles.resize(0);
+    m_batch_body = NULL;
+    Track* track = Track::getCurrentTrack();
+    if (!track)
+        return;
+    btRigidBody* body =
+        const_cast<btRigidBody*>(track->getTriangleMesh().getBody());
+    if (!body || !body->getBroadphaseHandle() ||
+        body->getCollisionShape()->getShapeType() !=
+        TRIANGLE_MESH_SHAPE_PROXYTYPE)
+        return;
+
+    btVector3 local_min, local_max;
+    btTransformAabb(aabb_min, aabb_max, 0.0f,
+                    body->getWorldTransform().inverse(), local_min,
+                    local_max);
+    Collector collector;
+    collector.m_triangles = &m_batch_triangles;
+    static_cast<btBvhTriangleMeshShape*>(body->getCollisionShape())
+        ->processAllTriangles(&collector, local_min, local_max);
+    m_batch_body = body;
+}   // beginBatch
+
+// ----------------------------------------------------------------------------
+void btKartRaycaster::endBatch()
+{
+    m_batch_body = NULL;
+}   // endBatch
+
+// ----------------------------------------------------------------------------
+/** Casts a ray against the world. If a batch is active, the ray must be
+ *  inside the area of the batch.
+ */
+void* btKartRaycaster::castRay(const btVector3& from, const btVector3& to,
+                               btVehicleRaycasterResult& result)
+{
+    ClosestWithNormal rayCallback(from, to, m_batch_body);
 
     m_dynamicsWorld->rayTest(from, to, rayCallback);
 
+    if (m_batch_body)
+    {
+        // Test the track triangles the ray test above skipped
+        const btTransform inv = m_batch_body->getWorldTransform().inverse();
+        BatchTriangleRaycast triangle_callback(inv(from), inv(to),
+                                               &rayCallback, m_batch_body);
+        for (int i = 0; i < m_batch_triangles.size(); i++)
+        {
+            BatchTriangle& t = m_batch_triangles[i];
+            triangle_callback.processTriangle(t.m_vertices, t.m_part,
+                                              t.m_index);
+        }
+    }
+
+
     if (rayCallback.hasHit())
     {
         btRigidBody* body = btRigidBody::upcast(rayCallback.m_collisionObject);
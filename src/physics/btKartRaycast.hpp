@@ -23,19 +23,40 @@ class btDynamicsWorld;
 class btKartRaycaster : public btVehicleRaycaster
 {
 private:
+    /** A triangle of the track near the wheels of a kart. */
+    struct BatchTriangle
+    {
+        btVector3 m_vertices[3];
+        int       m_part;
+        int       m_index;
+    };
+
     btDynamicsWorld*    m_dynamicsWorld;
     /** True if the normals should be smoothed. Not all tracks support this,
     *  so this flag is set depending on track when constructing this object. */
     bool                m_smooth_normals;
+
+    /** The body of the track while a batch is active, NULL otherwise. */
+    btRigidBody*        m_batch_body;
+
+    /** All triangles of the track in the area of the current batch, so the
+     *  rays don't need to traverse the track bvh again. */
+    btAlignedObjectArray<BatchTriangle> m_batch_triangles;
+
 public:
     btKartRaycaster(btDynamicsWorld* world, bool smooth_normals=false)
-        :m_dynamicsWorld(world), m_smooth_normals(smooth_normals)
+        :m_dynamicsWorld(world), m_smooth_normals(smooth_normals),
+         m_batch_body(NULL)
     {
     }
 
     virtual void* castRay(const btVector3& from,const btVector3& to,
                           btVehicleRaycasterResult& result);
 
+    void beginBatch(const btVector3& aabb_min, const btVector3& aabb_max);
+
+    void endBatch();
+
 };
 
 
@@ -0,0 +1,173 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "physics/parallel_island_solver.hpp"
+
+#include "utils/string_utils.hpp"
+#include "utils/vs.hpp"
+
+#include "btBulletDynamicsCommon.h"
+
+#include <algorithm>
+
+// ----------------------------------------------------------------------------
+/** Constructor, starts num_threads-1 worker threads (the thread calling
+ *  solve() is used too).
+ *  \param num_threads Total number of threads to use.
+ *  \param deterministic If the results must not depend on the number of
+ *         threads.
+ */
+ParallelIslandSolver::ParallelIslandSolver(unsigned num_threads,
+                                           bool deterministic)
+                    : m_deterministic(deterministic)
+{
+    m_generation   = 0;
+    m_workers_done = 0;
+    m_exit         = false;
+    m_islands      = NULL;
+    m_bodies       = NULL;
+    m_manifolds    = NULL;
+    m_info         = NULL;
+    m_debug_drawer = NULL;
+    m_stack_alloc  = NULL;
+    m_dispatcher   = NULL;
+    m_next_island.store(0);
+    if (num_threads < 1)
+        num_threads = 1;
+    for (unsigned i = 0; i < num_threads; i++)
+        m_solvers.push_back(new btSequentialImpulseConstraintSolver());
+    for (unsigned i = 1; i < num_threads; i++)
+        m_threads.emplace_back(&ParallelIslandSolver::workerMain, this, i);
+}   // ParallelIslandSolver
+
+// ----------------------------------------------------------------------------
+ParallelIslandSolver::~ParallelIslandSolver()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_exit = true;
+    }
+    m_start_cv.notify_all();
+    for (std::thread& t : m_threads)
+        t.join();
+    for (btSequentialImpulseConstraintSolver* solver : m_solvers)
+        delete solver;
+}   // ~ParallelIslandSolver
+
+// ----------------------------------------------------------------------------
+void ParallelIslandSolver::workerMain(unsigned index)
+{
+    VS::setThreadName((StringUtils::toString(index) + "Physics").c_str());
+    uint64_t generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> ul(m_mutex);
+            m_start_cv.wait(ul, [this, generation]
+                {
+                    return m_exit || m_generation != generation;
+                });
+            if (m_exit)
+                return;
+            generation = m_generation;
+        }
+        solveIslands(index);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_workers_done++;
+        }
+        m_done_cv.notify_one();
+    }
+}   // workerMain
+
+// ----------------------------------------------------------------------------
+/** Solves islands till there are none left.
+ *  \param index Index of the solver to use.
+ */
+void ParallelIslandSolver::solveIslands(unsigned index)
+{
+    btSequentialImpulseConstraintSolver* solver = m_solvers[index];
+    while (true)
+    {
+        int n = m_next_island.fetch_add(1);
+        if (n >= (int)m_order.size())
+            return;
+        const Island& island = (*m_islands)[m_order[n]];
+        if (m_deterministic)
+            solver->setRandSeed(0);
+        solver->solveGroup(m_bodies + island.m_first_body,
+                           island.m_num_bodies,
+                           m_manifolds + island.m_first_manifold,
+                           island.m_num_manifolds, island.m_constraints,
+                           island.m_num_constraints, *m_info,
+                           m_debug_drawer, m_stack_alloc, m_dispatcher);
+    }
+}   // solveIslands
+
+// ----------------------------------------------------------------------------
+/** Solves all islands, and returns when all are done.
+ *  \param islands The islands to solve.
+ *  \param bodies Bodies of all islands.
+ *  \param manifolds Contact manifolds of all islands.
+ */
+void ParallelIslandSolver::solve(const std::vector<Island>& islands,
+                                 btCollisionObject** bodies,
+                                 btPersistentManifold** manifolds,
+                                 const btContactSolverInfo& info,
+                                 btIDebugDraw* debug_drawer,
+                                 btStackAlloc* stack_alloc,
+                                 btDispatcher* dispatcher)
+{
+    m_islands      = &islands;
+    m_bodies       = bodies;
+    m_manifolds    = manifolds;
+    m_info         = &info;
+    m_debug_drawer = debug_drawer;
+    m_stack_alloc  = stack_alloc;
+    m_dispatcher   = dispatcher;
+
+    m_order.resize(islands.size());
+    for (unsigned i = 0; i < islands.size(); i++)
+        m_order[i] = i;
+    std::stable_sort(m_order.begin(), m_order.end(), [&islands](int a, int b)
+        {
+            return islands[a].m_num_manifolds + islands[a].m_num_constraints >
+                   islands[b].m_num_manifolds + islands[b].m_num_constraints;
+        });
+    m_next_island.store(0);
+
+    // Don't wake up the worker threads if there is nothing to share
+    if (islands.size() < 2 || m_threads.empty())
+    {
+        solveIslands(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_workers_done = 0;
+        m_generation++;
+    }
+    m_start_cv.notify_all();
+    solveIslands(0);
+    std::unique_lock<std::mutex> ul(m_mutex);
+    m_done_cv.wait(ul, [this]
+        {
+            return m_workers_done == m_threads.size();
+        });
+}   // solve
@@ -0,0 +1,130 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_PARALLEL_ISLAND_SOLVER_HPP
+#define HEADER_PARALLEL_ISLAND_SOLVER_HPP
+
+#include "utils/no_copy.hpp"
+#include "utils/types.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class btCollisionObject;
+class btDispatcher;
+class btIDebugDraw;
+class btPersistentManifold;
+class btSequentialImpulseConstraintSolver;
+class btStackAlloc;
+class btTypedConstraint;
+struct btContactSolverInfo;
+
+/**
+  * \ingroup physics
+  * Solves the constraints of independent simulation islands (e.g. groups of
+  * karts touching each other, or a flyable hitting a kart) in parallel.
+  * Each thread uses its own sequential impulse solver, and each island is
+  * solved on its own. Since islands don't share any dynamic body, the result
+  * of an island doesn't depend on which thread solves it or in which order
+  * the islands are solved, unless the solver mode randomizes the order of
+  * constraints: then the result depends on the random seed of the solver.
+  * In deterministic mode this seed is reset for each island, and
+  * Physics::init makes bullet solve each island on its own in the main
+  * thread too (instead of merging small islands), so the results on the
+  * server don't depend on the number of threads. Clients are not affected.
+  */
+class ParallelIslandSolver : public NoCopy
+{
+public:
+    /** An island, the bodies and manifolds are indices into the arrays
+     *  passed to solve(). */
+    struct Island
+    {
+        int                 m_first_body;
+        int                 m_num_bodies;
+        int                 m_first_manifold;
+        int                 m_num_manifolds;
+        btTypedConstraint** m_constraints;
+        int                 m_num_constraints;
+    };
+
+private:
+    /** One solver for each thread, the first one is used by the thread
+     *  calling solve(). */
+    std::vector<btSequentialImpulseConstraintSolver*> m_solvers;
+
+    std::vector<std::thread> m_threads;
+
+    const bool m_deterministic;
+
+    std::mutex m_mutex;
+
+    /** Used to wake up the worker threads. */
+    std::condition_variable m_start_cv;
+
+    /** Used to wait till all worker threads are done. */
+    std::condition_variable m_done_cv;
+
+    /** Increased for each call to solve(), so the worker threads know that
+     *  there is new work. */
+    uint64_t m_generation;
+
+    /** Number of worker threads which finished the current islands. */
+    unsigned m_workers_done;
+
+    bool m_exit;
+
+    /** Index into m_order of the next island to solve. */
+    std::atomic<int> m_next_island;
+
+    /** Indices of the islands, largest first for better load balancing. */
+    std::vector<int> m_order;
+
+    /** The data of the current call to solve(). */
+    const std::vector<Island>*  m_islands;
+    btCollisionObject**         m_bodies;
+    btPersistentManifold**      m_manifolds;
+    const btContactSolverInfo*  m_info;
+    btIDebugDraw*               m_debug_drawer;
+    btStackAlloc*               m_stack_alloc;
+    btDispatcher*               m_dispatcher;
+
+    // ------------------------------------------------------------------------
+    void workerMain(unsigned index);
+    // ------------------------------------------------------------------------
+    void solveIslands(unsigned index);
+
+public:
+    // ------------------------------------------------------------------------
+    ParallelIslandSolver(unsigned num_threads, bool deterministic);
+    // ------------------------------------------------------------------------
+    ~ParallelIslandSolver();
+    // ------------------------------------------------------------------------
+    void solve(const std::vector<Island>& islands,
+               btCollisionObject** bodies, btPersistentManifold** manifolds,
+               const btContactSolverInfo& info, btIDebugDraw* debug_drawer,
+               btStackAlloc* stack_alloc, btDispatcher* dispatcher);
+    // ------------------------------------------------------------------------
+    unsigned getNumThreads() const { return (unsigned)m_solvers.size(); }
+
+};   // ParallelIslandSolver
+
+#endif
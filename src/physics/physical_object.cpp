@@ -31,6 +31,7 @@
 #include "physics/triangle_mesh.hpp"
 #include "network/compress_network_body.hpp"
 #include "network/network_config.hpp"
+#include "network/rewind_manager.hpp"
 #include "network/protocols/lobby_protocol.hpp"
 #include "tracks/track.hpp"
 #include "tracks/track_object.hpp"
@@ -172,6 +173,7 @@ PhysicalObject::PhysicalObject(bool is_dynamic,
         btQuaternion(0.0f, 0.0f, 0.0f, 1.0f));
 
     m_last_transform = m_current_transform;
+    m_last_sleeping = false;
     m_no_server_state = false;
 
     m_body_added = false;
@@ -660,12 +662,14 @@ void PhysicalObject::update(float dt)
  *         based on the three normals of the triangle and the location of the
  *         hit point (which is more compute intensive, but results in much
  *         smoother results).
+ *  \param flags If not NULL, the terrain flags of the triangle hit.
  *  \return True if a triangle was hit, false otherwise (and no output
  *          variable will be set.
  */
 bool PhysicalObject::castRay(const btVector3 &from, const btVector3 &to, 
                              btVector3 *hit_point, const Material **material, 
-                             btVector3 *normal, bool interpolate_normal) const
+                             btVector3 *normal, bool interpolate_normal,
+                             uint16_t *flags) const
 {
     if(m_body_type!=MP_EXACT)
     {
@@ -674,7 +678,7 @@ bool PhysicalObject::castRay(const btVector3 &from, const btVector3 &to,
     }
     bool result = m_triangle_mesh->castRay(from, to, hit_point, 
                                            material, normal, 
-                                           interpolate_normal);
+                                           interpolate_normal, flags);
     return result;
 }   // castRay
 
@@ -689,6 +693,7 @@ void PhysicalObject::reset()
 
     m_last_transform = m_init_pos;
     m_last_lv = m_last_av = Vec3(0.0f);
+    m_last_sleeping = false;
 }   // reset
 
 // ----------------------------------------------------------------------------
@@ -827,20 +832,31 @@ BareNetworkString* PhysicalObject::saveState(std::vector<std::string>* ru)
     btTransform cur_transform = m_body->getWorldTransform();
     Vec3 current_lv = m_body->getLinearVelocity();
     Vec3 current_av = m_body->getAngularVelocity();
+    // Sleeping bodies are not simulated, so clients need to know it too to
+    // predict the same (resting) state
+    const bool sleeping = RewindManager::get()->sendSleepState() &&
+        m_body->getActivationState() == ISLAND_SLEEPING;
 
     if ((cur_transform.getOrigin() - m_last_transform.getOrigin())
         .length() < 0.01f &&
         (current_lv - m_last_lv).length() < 0.01f &&
-        (current_av - m_last_av).length() < 0.01f && !has_live_join)
+        (current_av - m_last_av).length() < 0.01f &&
+        sleeping == m_last_sleeping && !has_live_join)
     {
         delete buffer;
         return nullptr;
     }
 
+    // Only added when sleeping, so the state of awake objects is compatible
+    // with older clients
+    if (sleeping)
+        buffer->addUInt8(1);
+
     ru->push_back(getUniqueIdentity());
     m_last_transform = cur_transform;
     m_last_lv = current_lv;
     m_last_av = current_av;
+    m_last_sleeping = sleeping;
     return buffer;
 }   // saveState
 
@@ -849,6 +865,14 @@ void PhysicalObject::restoreState(BareNetworkString *buffer, int count)
 {
     m_no_server_state = false;
     CompressNetworkBody::decompress(buffer, m_body, m_motion_state);
+    m_last_sleeping = count > CompressNetworkBody::COMPRESSED_SIZE;
+    if (m_last_sleeping)
+    {
+        buffer->getUInt8();
+        m_body->forceActivationState(ISLAND_SLEEPING);
+    }
+    else
+        m_body->activate();
     // Save the newly decompressed value for local state restore
     m_last_transform = m_body->getWorldTransform();
     m_last_lv = m_body->getLinearVelocity();
@@ -861,7 +885,9 @@ std::function<void()> PhysicalObject::getLocalStateRestoreFunction()
     btTransform t = m_body->getWorldTransform();
     Vec3 lv = m_body->getLinearVelocity();
     Vec3 av = m_body->getAngularVelocity();
-    return [t, lv, av, this]()
+    int activation_state = m_body->getActivationState();
+    float deactivation_time = m_body->getDeactivationTime();
+    return [t, lv, av, activation_state, deactivation_time, this]()
     {
         if (m_no_server_state)
         {
@@ -872,6 +898,10 @@ std::function<void()> PhysicalObject::getLocalStateRestoreFunction()
             m_body->setAngularVelocity(m_last_av);
             m_body->setInterpolationLinearVelocity(m_last_lv);
             m_body->setInterpolationAngularVelocity(m_last_av);
+            if (m_last_sleeping)
+                m_body->forceActivationState(ISLAND_SLEEPING);
+            else
+                m_body->activate();
         }
         else
         {
@@ -882,6 +912,8 @@ std::function<void()> PhysicalObject::getLocalStateRestoreFunction()
             m_body->setAngularVelocity(av);
             m_body->setInterpolationLinearVelocity(lv);
             m_body->setInterpolationAngularVelocity(av);
+            m_body->forceActivationState(activation_state);
+            m_body->setDeactivationTime(deactivation_time);
         }
     };
 }   // getLocalStateRestoreFunction
@@ -1029,7 +1061,7 @@ void PhysicalObject::copyFromMainProcess(TrackObject* track_obj)
     {
         const TriangleMesh& old_tm = *m_triangle_mesh;
         m_triangle_mesh = new TriangleMesh(/*can_be_transformed*/true);
-        m_triangle_mesh->copyFrom(old_tm);
+        m_triangle_mesh->shareFrom(old_tm);
     }
     // At the moment no bullet collision shape here has pointer in used in
     // their member values, so we can use copy constructor directly
@@ -191,6 +191,9 @@ private:
     Vec3                  m_last_lv;
     Vec3                  m_last_av;
 
+    /* True if the last state recieved or saved had the body sleeping */
+    bool                  m_last_sleeping;
+
     /* Used to determine if local state should be used, which is true
      * when the object is not moving */
     bool                  m_no_server_state;
@@ -215,7 +218,7 @@ public:
     bool castRay(const btVector3 &from,
                  const btVector3 &to, btVector3 *hit_point,
                  const Material **material, btVector3 *normal,
-                 bool interpolate_normal) const;
+                 bool interpolate_normal, uint16_t *flags=NULL) const;
 
     // ------------------------------------------------------------------------
     bool isDynamic() const { return m_is_dynamic; }
@@ -29,12 +29,15 @@
 #include "karts/kart_properties.hpp"
 #include "karts/rescue_animation.hpp"
 #include "karts/controller/local_player_controller.hpp"
+#include "modes/profile_world.hpp"
 #include "modes/soccer_world.hpp"
 #include "modes/world.hpp"
 #include "network/network_config.hpp"
+#include "network/server_config.hpp"
 #include "karts/explosion_animation.hpp"
 #include "physics/btKart.hpp"
 #include "physics/irr_debug_drawer.hpp"
+#include "physics/parallel_island_solver.hpp"
 #include "physics/physical_object.hpp"
 #include "physics/stk_dynamics_world.hpp"
 #include "physics/triangle_mesh.hpp"
@@ -42,8 +45,12 @@
 #include "scriptengine/script_engine.hpp"
 #include "tracks/track.hpp"
 #include "tracks/track_object.hpp"
+#include "utils/log.hpp"
 #include "utils/profiler.hpp"
 #include "utils/stk_process.hpp"
+#include "utils/time.hpp"
+
+#include <algorithm>
 
 //=============================================================================
 Physics* g_physics[PT_COUNT];
@@ -77,22 +84,72 @@ Physics::Physics() : btSequentialImpulseConstraintSolver()
 {
     m_collision_conf      = new btDefaultCollisionConfiguration();
     m_dispatcher          = new btCollisionDispatcher(m_collision_conf);
+    m_step_time           = 0.0;
+    m_num_steps           = 0;
+    m_parallel_solver     = NULL;
+    m_deterministic_islands = false;
 }   // Physics
 
+//-----------------------------------------------------------------------------
+/** Creates the broadphase. The type is taken from the command line, the
+ *  track or stk_config (in this order), the world bounds (which are not used
+ *  by dbvt) are the track bounds plus a margin.
+ */
+btBroadphaseInterface* Physics::createBroadphase(const Vec3 &world_min,
+                                                 const Vec3 &world_max)
+{
+    std::string name = UserConfigParams::m_broadphase;
+    if (name.empty())
+        name = Track::getCurrentTrack()->getBroadphase();
+    if (name.empty())
+        name = stk_config->m_broadphase;
+
+    const btVector3 margin(stk_config->m_broadphase_margin,
+                           stk_config->m_broadphase_margin,
+                           stk_config->m_broadphase_margin);
+    const btVector3 min = world_min - margin;
+    const btVector3 max = world_max + margin;
+    m_broadphase_name = name;
+    if (name == "dbvt")
+        return new btDbvtBroadphase();
+    else if (name == "axis-sweep-32")
+        return new bt32BitAxisSweep3(min, max);
+    else if (name != "axis-sweep")
+    {
+        Log::warn("Physics", "Unknown broadphase '%s', using axis-sweep.",
+                  name.c_str());
+        m_broadphase_name = "axis-sweep";
+    }
+    return new btAxisSweep3(min, max);
+}   // createBroadphase
+
 //-----------------------------------------------------------------------------
 /** The actual initialisation of the physics, which is called after the track
  *  model is loaded. This allows the physics to use the actual track dimension
- *  for the axis sweep.
+ *  for the broadphase.
  */
 void Physics::init(const Vec3 &world_min, const Vec3 &world_max)
 {
     m_physics_loop_active = false;
-    m_axis_sweep          = new btAxisSweep3(world_min, world_max);
+    m_broadphase          = createBroadphase(world_min, world_max);
+    m_step_time           = 0.0;
+    m_num_steps           = 0;
     m_dynamics_world      = new STKDynamicsWorld(m_dispatcher,
-                                                 m_axis_sweep,
+                                                 m_broadphase,
                                                  this,
                                                  m_collision_conf);
     m_karts_to_delete.clear();
+    const bool is_server = NetworkConfig::get()->isNetworking() &&
+                           NetworkConfig::get()->isServer();
+    m_deterministic_islands = is_server &&
+                              ServerConfig::m_physics_deterministic;
+    if (is_server && ServerConfig::m_physics_threads > 1)
+    {
+        m_parallel_solver = new ParallelIslandSolver(
+            ServerConfig::m_physics_threads,
+            ServerConfig::m_physics_deterministic);
+        m_dynamics_world->setParallelSolver(m_parallel_solver);
+    }
     m_dynamics_world->setGravity(
         btVector3(0.0f,
                   -Track::getCurrentTrack()->getGravity(),
@@ -110,14 +167,28 @@ void Physics::init(const Vec3 &world_min, const Vec3 &world_max)
     // Modify the mode according to the bits of the solver mode:
     info.m_solverMode = (info.m_solverMode & (~stk_config->m_solver_reset_flags))
                       | stk_config->m_solver_set_flags;
+
+    // By default bullet merges small islands before solving them in the
+    // main thread, while the parallel island solver solves each island on
+    // its own. Solve each island separately in both cases so the results
+    // don't depend on the number of physics threads.
+    if (m_deterministic_islands)
+        info.m_minimumSolverBatchSize = 1;
 }   // init
 
 //-----------------------------------------------------------------------------
 Physics::~Physics()
 {
+    if (m_num_steps > 0)
+    {
+        Log::info("Physics", "Average physics step %f ms over %d steps "
+                  "using broadphase %s.", m_step_time * 1000.0 / m_num_steps,
+                  m_num_steps, m_broadphase_name.c_str());
+    }
     delete m_debug_drawer;
     delete m_dynamics_world;
-    delete m_axis_sweep;
+    delete m_parallel_solver;
+    delete m_broadphase;
     delete m_dispatcher;
     delete m_collision_conf;
 }   // ~Physics
@@ -190,16 +261,24 @@ void Physics::update(int ticks)
     // Since the world update (which calls physics update) is called at the
     // fixed frequency necessary for the physics update, we need to do exactly
     // one physic step only.
-    double start;
-    if(UserConfigParams::m_physics_debug) start = StkTime::getRealTime();
+    double start = 0.0;
+    const bool measure = UserConfigParams::m_physics_debug ||
+                         UserConfigParams::m_arena_ai_stats ||
+                         ProfileWorld::isProfileMode();
+    if (measure) start = StkTime::getRealTime();
 
     m_dynamics_world->stepSimulation(stk_config->ticks2Time(1), 1,
                                      stk_config->ticks2Time(1)      );
-    if (UserConfigParams::m_physics_debug)
+    if (measure)
     {
-        Log::verbose("Physics", "At %d physics duration %12.8f",
-                     World::getWorld()->getTicksSinceStart(),
-                     StkTime::getRealTime() - start);
+        double duration = StkTime::getRealTime() - start;
+        m_step_time += duration;
+        m_num_steps++;
+        if (UserConfigParams::m_physics_debug)
+        {
+            Log::verbose("Physics", "At %d physics duration %12.8f",
+                         World::getWorld()->getTicksSinceStart(), duration);
+        }
     }
 
     // Now handle the actual collision. Note: flyables can not be removed
@@ -576,6 +655,12 @@ btScalar Physics::solveGroup(btCollisionObject** bodies, int numBodies,
                              btStackAlloc* stackAlloc,
                              btDispatcher* dispatcher)
 {
+    // Reset the random seed (only used if the solver mode randomizes the
+    // order of constraints) for each island, like the parallel island
+    // solver does, so the result doesn't depend on how many islands were
+    // solved before or on which thread.
+    if (m_deterministic_islands)
+        setRandSeed(0);
     btScalar returnValue=
         btSequentialImpulseConstraintSolver::solveGroup(bodies, numBodies,
                                                         manifold, numManifolds,
@@ -584,6 +669,29 @@ btScalar Physics::solveGroup(btCollisionObject** bodies, int numBodies,
                                                         debugDrawer,
                                                         stackAlloc,
                                                         dispatcher);
+    processCollisions();
+    return returnValue;
+}   // solveGroup
+
+//-----------------------------------------------------------------------------
+/** Called by bullet after all islands are solved. If the islands were solved
+ *  in parallel (so solveGroup was not called), the collisions are handled
+ *  here once.
+ */
+void Physics::allSolved(const btContactSolverInfo& info,
+                        btIDebugDraw* debugDrawer, btStackAlloc* stackAlloc)
+{
+    btSequentialImpulseConstraintSolver::allSolved(info, debugDrawer,
+                                                   stackAlloc);
+    if (m_dynamics_world->getNumParallelIslands() > 0)
+        processCollisions();
+}   // allSolved
+
+//-----------------------------------------------------------------------------
+/** Stores all collisions of the current contact manifolds (see solveGroup).
+ */
+void Physics::processCollisions()
+{
     int currentNumManifolds = m_dispatcher->getNumManifolds();
     // We can't explode a rocket in a loop, since a rocket might collide with
     // more than one object, and/or more than once with each object (if there
@@ -755,9 +863,7 @@ btScalar Physics::solveGroup(btCollisionObject** bodies, int numBodies,
         else
             assert("Unknown user pointer");           // 4) Should never happen
     }   // for i<numManifolds
-
-    return returnValue;
-}   // solveGroup
+}   // processCollisions
 
 // ----------------------------------------------------------------------------
 /** A debug draw function to show the track and all karts.
@@ -782,6 +888,193 @@ void Physics::draw()
     return;
 }   // draw
 
+// ============================================================================
+/** Hashes the (sorted) pair of user pointers of a collision. */
+uint32_t Physics::CollisionList::hash(const UserPointer *a,
+                                      const UserPointer *b)
+{
+    uint64_t h = (uint64_t)(uintptr_t)a * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t)(uintptr_t)b + 0x7F4A7C15ull + (h << 6) + (h >> 2);
+    h *= 0xBF58476D1CE4E5B9ull;
+    return (uint32_t)(h >> 32);
+}   // hash
+
+// ----------------------------------------------------------------------------
+/** Adds the index of a collision pair (which must not be in the set yet)
+ *  to the hash set. */
+void Physics::CollisionList::insertIndex(int index)
+{
+    const CollisionPair &p = (*this)[index];
+    const uint32_t mask = (uint32_t)m_slots.size() - 1;
+    uint32_t i = hash(p.getUserPointer(0), p.getUserPointer(1)) & mask;
+    while (m_slots[i].m_generation == m_generation)
+        i = (i + 1) & mask;
+    m_slots[i].m_generation = m_generation;
+    m_slots[i].m_index = index;
+}   // insertIndex
+
+// ----------------------------------------------------------------------------
+/** Doubles the size of the hash set and re-adds all pairs. */
+void Physics::CollisionList::grow()
+{
+    m_slots.assign(m_slots.size() * 2, Slot{0, 0});
+    m_generation = 1;
+    for (int i = 0; i < (int)size(); i++)
+        insertIndex(i);
+}   // grow
+
+// ----------------------------------------------------------------------------
+/** Removes all collisions. The memory of the list and the hash set is kept,
+ *  the slots of the hash set become unused by changing the generation. */
+void Physics::CollisionList::clear()
+{
+    std::vector<CollisionPair>::clear();
+    m_generation++;
+    if (m_generation == 0)
+    {
+        m_slots.assign(m_slots.size(), Slot{0, 0});
+        m_generation = 1;
+    }
+}   // clear
+
+// ----------------------------------------------------------------------------
+/** Adds a collision pair, but only if the same objects are not already in
+ *  the list. */
+void Physics::CollisionList::push_back(const CollisionPair &p)
+{
+    const uint32_t mask = (uint32_t)m_slots.size() - 1;
+    uint32_t i = hash(p.getUserPointer(0), p.getUserPointer(1)) & mask;
+    while (m_slots[i].m_generation == m_generation)
+    {
+        if ((*this)[m_slots[i].m_index] == p)
+            return;
+        i = (i + 1) & mask;
+    }
+    std::vector<CollisionPair>::push_back(p);
+    // Keep the load factor at most 1/2
+    if (size() * 2 > m_slots.size())
+        grow();
+    else
+    {
+        m_slots[i].m_generation = m_generation;
+        m_slots[i].m_index = (int)size() - 1;
+    }
+}   // push_back
+
+// ----------------------------------------------------------------------------
+/** Unit testing of the collision list, and a benchmark comparing it with a
+ *  linear search in a crowded arena (many karts, flyables and physical
+ *  objects with up to 4 contact points each and duplicates from substeps).
+ */
+void Physics::unitTesting()
+{
+    const int NUM_KARTS = 16;
+    const int NUM_FLYABLES = 40;
+    const int NUM_OBJECTS = 60;
+    std::vector<UserPointer> up(1 + NUM_KARTS + NUM_FLYABLES + NUM_OBJECTS);
+    up[0].set((TriangleMesh*)NULL);
+    for (int i = 1; i <= NUM_KARTS; i++)
+        up[i].set((AbstractKart*)NULL);
+    for (int i = 1 + NUM_KARTS; i <= NUM_KARTS + NUM_FLYABLES; i++)
+        up[i].set((Flyable*)NULL);
+    for (int i = 1 + NUM_KARTS + NUM_FLYABLES; i < (int)up.size(); i++)
+        up[i].set((PhysicalObject*)NULL);
+
+    const btVector3 zero(0, 0, 0);
+    CollisionList list;
+    // Kart pairs are sorted, so both orders are the same collision
+    list.push_back(&up[1], zero, &up[2], zero);
+    list.push_back(&up[2], zero, &up[1], zero);
+    list.push_back(&up[1], zero, &up[0], zero);
+    list.push_back(&up[1], zero, &up[0], zero);
+    assert(list.size() == 2);
+    assert(list[0].getUserPointer(0) == &up[1]);
+    assert(list[0].getUserPointer(1) == &up[2]);
+    assert(list[1].getUserPointer(1) == &up[0]);
+    list.clear();
+    assert(list.size() == 0);
+    list.push_back(&up[2], zero, &up[1], zero);
+    assert(list.size() == 1);
+
+    // Grow the hash set, all pairs must still be found
+    list.clear();
+    for (unsigned i = 0; i < up.size(); i++)
+    {
+        for (unsigned j = 0; j < up.size(); j++)
+        {
+            if (i != j && !(up[i].is(UserPointer::UP_KART) &&
+                            up[j].is(UserPointer::UP_KART) && i > j))
+                list.push_back(&up[i], zero, &up[j], zero);
+        }
+    }
+    const unsigned all_pairs = list.size();
+    for (unsigned i = 0; i < up.size(); i++)
+    {
+        for (unsigned j = 0; j < up.size(); j++)
+        {
+            if (i != j)
+                list.push_back(&up[i], zero, &up[j], zero);
+        }
+    }
+    assert(list.size() == all_pairs);
+    (void)all_pairs;
+
+    // Benchmark: each tick every kart and flyable touches the track, and
+    // random pairs of objects touch each other, each reported 4 times
+    std::vector<std::pair<int, int> > contacts;
+    uint32_t seed = 1;
+    for (int i = 1; i < (int)up.size(); i++)
+        contacts.emplace_back(i, 0);
+    for (int i = 0; i < 400; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        int a = 1 + (seed >> 8) % (up.size() - 1);
+        seed = seed * 1103515245 + 12345;
+        int b = 1 + (seed >> 8) % (up.size() - 1);
+        if (a != b)
+            contacts.emplace_back(a, b);
+    }
+    const int ticks = 200;
+    double start = StkTime::getRealTime();
+    unsigned hashed_size = 0;
+    for (int t = 0; t < ticks; t++)
+    {
+        list.clear();
+        for (int n = 0; n < 4; n++)
+        {
+            for (auto& c : contacts)
+            {
+                list.push_back(&up[c.first], zero, &up[c.second], zero);
+            }
+        }
+        hashed_size = list.size();
+    }
+    double hashed_time = StkTime::getRealTime() - start;
+
+    start = StkTime::getRealTime();
+    std::vector<CollisionPair> linear;
+    for (int t = 0; t < ticks; t++)
+    {
+        linear.clear();
+        for (int n = 0; n < 4; n++)
+        {
+            for (auto& c : contacts)
+            {
+                CollisionPair p(&up[c.first], zero, &up[c.second], zero);
+                if (std::find(linear.begin(), linear.end(), p) ==
+                    linear.end())
+                    linear.push_back(p);
+            }
+        }
+    }
+    double linear_time = StkTime::getRealTime() - start;
+    assert(linear.size() == hashed_size);
+    Log::info("Physics", "Collision list with %d pairs from %d contacts: "
+        "hash set %.3f ms, linear search %.3f ms per step.", hashed_size,
+        (int)contacts.size() * 4, hashed_time * 1000.0 / ticks,
+        linear_time * 1000.0 / ticks);
+}   // unitTesting
+
 // ----------------------------------------------------------------------------
 
 /* EOF */
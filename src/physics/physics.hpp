@@ -25,6 +25,7 @@
   */
 
 #include <set>
+#include <string>
 #include <vector>
 
 #include "btBulletDynamicsCommon.h"
@@ -32,8 +33,10 @@
 #include "physics/irr_debug_drawer.hpp"
 #include "physics/stk_dynamics_world.hpp"
 #include "physics/user_pointer.hpp"
+#include "utils/types.hpp"
 
 class AbstractKart;
+class ParallelIslandSolver;
 class STKDynamicsWorld;
 class Vec3;
 
@@ -49,10 +52,9 @@ private:
      *  duplicates. To handle this, all collisions (i.e. pair of objects)
      *  are stored in a vector, but only one entry per collision pair
      *  of objects.
-     *  While this is a natural application of std::set, the set has some
-     *  overhead (since it will likely use a tree to sort the entries).
-     *  Considering that the number of collisions is usually rather small
-     *  a simple list and linear search is faster is is being used here. */
+     *  With many karts, flyables and physical objects (e.g. in free for
+     *  all) the number of reported contacts can be large, so a hash set is
+     *  used to find duplicates, see CollisionList. */
     class CollisionPair
     {
     private:
@@ -81,7 +83,7 @@ private:
         /** Tests if two collision pairs involve the same objects. This test
          *  is simplified (i.e. no test if p.b==a and p.a==b) since the
          *  elements are sorted. */
-        bool operator==(const CollisionPair &p)
+        bool operator==(const CollisionPair &p) const
         {
             return (p.m_up[0]==m_up[0] && p.m_up[1]==m_up[1]);
         }   // operator==
@@ -103,18 +105,44 @@ private:
 
     // ========================================================================
     // This class is the list of collision objects, where each collision
-    // pair is stored as most once.
-    class CollisionList : public std::vector<CollisionPair>
+    // pair is stored as most once. The list is kept in the order in which
+    // the collisions were reported, an open addressing hash set of indices
+    // into the list is used to find duplicates.
+    class CollisionList : private std::vector<CollisionPair>
     {
     private:
-        void push_back(CollisionPair p) {
-            // only add a pair if it's not already in there
-            for(iterator i=begin(); i!=end(); i++) {
-                if((*i)==p) return;
-            }
-            std::vector<CollisionPair>::push_back(p);
-        };  // push_back
+        /** A slot of the hash set. It is only used if its generation is the
+         *  current one, so clearing the list doesn't need to touch the
+         *  slots (which are kept between time steps). */
+        struct Slot
+        {
+            uint32_t m_generation;
+            int      m_index;
+        };
+        std::vector<Slot> m_slots;
+
+        /** Increased each time the list is cleared. */
+        uint32_t m_generation;
+        // --------------------------------------------------------------------
+        static uint32_t hash(const UserPointer *a, const UserPointer *b);
+        // --------------------------------------------------------------------
+        void insertIndex(int index);
+        // --------------------------------------------------------------------
+        void grow();
+        // --------------------------------------------------------------------
+        void push_back(const CollisionPair &p);
     public:
+        using std::vector<CollisionPair>::iterator;
+        using std::vector<CollisionPair>::const_iterator;
+        using std::vector<CollisionPair>::begin;
+        using std::vector<CollisionPair>::end;
+        using std::vector<CollisionPair>::size;
+        using std::vector<CollisionPair>::operator[];
+        // --------------------------------------------------------------------
+        CollisionList() : m_slots(64, Slot{0, 0}), m_generation(1) {}
+        // --------------------------------------------------------------------
+        void clear();
+        // --------------------------------------------------------------------
         /** Adds information about a collision to this vector. */
         void push_back(const UserPointer *a, const btVector3 &contact_point_a,
                        const UserPointer *b, const btVector3 &contact_point_b)
@@ -143,11 +171,32 @@ private:
     IrrDebugDrawer                  *m_debug_drawer;
 
     btCollisionDispatcher           *m_dispatcher;
-    btBroadphaseInterface           *m_axis_sweep;
+    btBroadphaseInterface           *m_broadphase;
     btDefaultCollisionConfiguration *m_collision_conf;
     CollisionList                    m_all_collisions;
 
+    /** Total time of all measured physics steps, only measured in profile
+     *  mode or with physics debugging. */
+    double                           m_step_time;
+
+    /** Number of measured physics steps. */
+    int                              m_num_steps;
+
+    /** Solves the islands in parallel on servers, NULL if not used. */
+    ParallelIslandSolver            *m_parallel_solver;
+
+    /** True on servers with physics-deterministic, then each island is
+     *  solved on its own with a reset random seed, so the results don't
+     *  depend on the number of physics threads. */
+    bool                             m_deterministic_islands;
+
+    /** Name of the broadphase used, for the statistics. */
+    std::string                      m_broadphase_name;
+
              Physics();
+    btBroadphaseInterface* createBroadphase(const Vec3 &world_min,
+                                            const Vec3 &world_max);
+    void  processCollisions();
     virtual ~Physics();
 
 public:
@@ -182,6 +231,10 @@ public:
                                 const btContactSolverInfo& info,
                                 btIDebugDraw* debugDrawer, btStackAlloc* stackAlloc,
                                 btDispatcher* dispatcher);
+    virtual void allSolved(const btContactSolverInfo& info,
+                           btIDebugDraw* debugDrawer, btStackAlloc* stackAlloc);
+    // ----------------------------------------------------------------------------------------
+    static void unitTesting();
 };
 
 #endif // HEADER_PHYSICS_HPP
@@ -0,0 +1,145 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "physics/stk_dynamics_world.hpp"
+
+#include "BulletCollision/CollisionDispatch/btSimulationIslandManager.h"
+
+namespace
+{
+// ----------------------------------------------------------------------------
+/** Returns the island of a constraint, the same way as bullet does it in
+ *  btDiscreteDynamicsWorld. */
+int getConstraintIslandId(const btTypedConstraint* c)
+{
+    const btCollisionObject& a = c->getRigidBodyA();
+    const btCollisionObject& b = c->getRigidBodyB();
+    return a.getIslandTag() >= 0 ? a.getIslandTag() : b.getIslandTag();
+}   // getConstraintIslandId
+
+// ============================================================================
+class SortConstraintOnIsland
+{
+public:
+    bool operator()(const btTypedConstraint* lhs,
+                    const btTypedConstraint* rhs) const
+    {
+        return getConstraintIslandId(lhs) < getConstraintIslandId(rhs);
+    }
+};   // SortConstraintOnIsland
+
+// ============================================================================
+/** Collects all islands which need to be solved, instead of solving them
+ *  immediately like bullet's island callback. */
+class IslandCollector : public btSimulationIslandManager::IslandCallback
+{
+private:
+    std::vector<ParallelIslandSolver::Island>* m_islands;
+    std::vector<btCollisionObject*>*           m_bodies;
+    std::vector<btPersistentManifold*>*        m_manifolds;
+    btTypedConstraint**                        m_constraints;
+    int                                        m_num_constraints;
+public:
+    IslandCollector(std::vector<ParallelIslandSolver::Island>* islands,
+                    std::vector<btCollisionObject*>* bodies,
+                    std::vector<btPersistentManifold*>* manifolds,
+                    btTypedConstraint** constraints, int num_constraints)
+        : m_islands(islands), m_bodies(bodies), m_manifolds(manifolds),
+          m_constraints(constraints), m_num_constraints(num_constraints)
+    {
+    }
+    // ------------------------------------------------------------------------
+    virtual void ProcessIsland(btCollisionObject** bodies, int num_bodies,
+                               btPersistentManifold** manifolds,
+                               int num_manifolds, int island_id)
+    {
+        ParallelIslandSolver::Island island;
+        if (island_id < 0)
+        {
+            // Islands are not split, all constraints are solved together
+            island.m_constraints     = m_constraints;
+            island.m_num_constraints = m_num_constraints;
+        }
+        else
+        {
+            island.m_constraints     = NULL;
+            island.m_num_constraints = 0;
+            for (int i = 0; i < m_num_constraints; i++)
+            {
+                if (getConstraintIslandId(m_constraints[i]) != island_id)
+                    continue;
+                if (!island.m_constraints)
+                    island.m_constraints = &m_constraints[i];
+                island.m_num_constraints++;
+            }
+        }
+        if (num_manifolds + island.m_num_constraints == 0)
+            return;
+        island.m_first_body     = (int)m_bodies->size();
+        island.m_num_bodies     = num_bodies;
+        island.m_first_manifold = (int)m_manifolds->size();
+        island.m_num_manifolds  = num_manifolds;
+        m_bodies->insert(m_bodies->end(), bodies, bodies + num_bodies);
+        m_manifolds->insert(m_manifolds->end(), manifolds,
+                            manifolds + num_manifolds);
+        m_islands->push_back(island);
+    }   // ProcessIsland
+};   // IslandCollector
+
+}   // namespace
+
+// ----------------------------------------------------------------------------
+/** Solves the constraints of all islands. Without a parallel solver this is
+ *  done by bullet, otherwise all islands are collected first and then solved
+ *  in parallel. The constraint solver of the world (Physics) is still
+ *  notified, so it can handle the collisions of this time step.
+ */
+void STKDynamicsWorld::solveConstraints(btContactSolverInfo& solver_info)
+{
+    if (!m_parallel_solver)
+    {
+        btDiscreteDynamicsWorld::solveConstraints(solver_info);
+        return;
+    }
+
+    m_sorted_constraints.resize(m_constraints.size());
+    for (int i = 0; i < m_constraints.size(); i++)
+        m_sorted_constraints[i] = m_constraints[i];
+    m_sorted_constraints.quickSort(SortConstraintOnIsland());
+    btTypedConstraint** constraints =
+        m_sorted_constraints.size() ? &m_sorted_constraints[0] : NULL;
+
+    m_islands.clear();
+    m_island_bodies.clear();
+    m_island_manifolds.clear();
+    IslandCollector collector(&m_islands, &m_island_bodies,
+                              &m_island_manifolds, constraints,
+                              m_sorted_constraints.size());
+
+    m_constraintSolver->prepareSolve(getNumCollisionObjects(),
+                                     getDispatcher()->getNumManifolds());
+    m_islandManager->buildAndProcessIslands(getDispatcher(), this,
+                                            &collector);
+    if (!m_islands.empty())
+    {
+        m_parallel_solver->solve(m_islands, m_island_bodies.data(),
+                                 m_island_manifolds.data(), solver_info,
+                                 m_debugDrawer, m_stackAlloc, m_dispatcher1);
+    }
+    m_constraintSolver->allSolved(solver_info, m_debugDrawer, m_stackAlloc);
+}   // solveConstraints
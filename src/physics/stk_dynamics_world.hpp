@@ -20,13 +20,29 @@
 #define HEADER_STK_DYNAMICS_WORLD_HPP
 
 #include "btBulletDynamicsCommon.h"
+#include "physics/parallel_island_solver.hpp"
+
+#include <vector>
 
 /** A thin wrapper around bullet's btDiscreteDynamicsWorld. Used to
  *  be able to query and set the 'left over' time from a previous
  *  time step, which is needed for more precise rewind/replays.
+ *  It can also solve the simulation islands in parallel.
  */
 class STKDynamicsWorld : public btDiscreteDynamicsWorld
 {
+private:
+    /** If not NULL, the islands are solved in parallel using this
+     *  solver. */
+    ParallelIslandSolver* m_parallel_solver;
+
+    /** The islands of the current time step, and their bodies and
+     *  manifolds. Kept to avoid allocations in each time step. */
+    std::vector<ParallelIslandSolver::Island> m_islands;
+    std::vector<btCollisionObject*>           m_island_bodies;
+    std::vector<btPersistentManifold*>        m_island_manifolds;
+    btAlignedObjectArray<btTypedConstraint*>  m_sorted_constraints;
+
 public:
     /** The standard constructor which just created a btDiscreteDynamicsWorld. */
     STKDynamicsWorld(btDispatcher*             dispatcher,
@@ -38,8 +54,25 @@ public:
                                              constraintSolver,
                                              collisionConfiguration)
     {
+        m_parallel_solver = NULL;
     }
-
+    // ------------------------------------------------------------------------
+    virtual void solveConstraints(btContactSolverInfo& solver_info);
+    // ------------------------------------------------------------------------
+    /** Sets the solver to solve islands in parallel (NULL to use bullet's
+     *  sequential solving). Not owned by the world. */
+    void setParallelSolver(ParallelIslandSolver* solver)
+    {
+        m_parallel_solver = solver;
+    }
+    // ------------------------------------------------------------------------
+    /** Returns the number of islands solved in parallel in the last time
+     *  step. */
+    unsigned getNumParallelIslands() const
+    {
+        return m_parallel_solver ? (unsigned)m_islands.size() : 0;
+    }
+    // ------------------------------------------------------------------------
     /** Resets m_localTime to 0. This allows more precise replay of
      *  physics, which is important for replaying histories. */
     void resetLocalTime() { m_localTime = 0; }
@@ -19,20 +19,32 @@
 #include "physics/triangle_mesh.hpp"
 
 #include "config/stk_config.hpp"
+#include "graphics/material.hpp"
+#include "io/file_manager.hpp"
 #include "main_loop.hpp"
 #include "physics/physics.hpp"
 #include "utils/constants.hpp"
+#include "utils/file_utils.hpp"
 #include "utils/log.hpp"
+#include "utils/string_utils.hpp"
 #include "utils/time.hpp"
 
 #include "btBulletDynamicsCommon.h"
 
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 
+/** Header of cached bvh files, padded to 16 bytes so the bvh following it
+ *  stays aligned. */
+static const char BVH_HEADER[] = "STK-BVH-1\0\0\0\0\0\0";
+static const int BVH_HEADER_SIZE = 16;
+
 // -----------------------------------------------------------------------------
 /** Constructor: Initialises all data structures with zero.
  */
-TriangleMesh::TriangleMesh(bool can_be_transformed) : m_mesh()
+TriangleMesh::TriangleMesh(bool can_be_transformed)
+            : m_data(std::make_shared<SharedData>())
 {
     m_body               = NULL;
     m_free_body          = true;
@@ -69,33 +81,195 @@ void TriangleMesh::addTriangle(const btVector3 &t1, const btVector3 &t2,
                                const btVector3 &n3,
                                const Material* m)
 {
-    m_triangleIndex2Material.push_back(m);
+    SharedData* d = m_data.get();
+    d->m_triangleIndex2Material.push_back(m);
+    d->m_triangle_flags.push_back(m ? m->getTerrainFlags() : 0);
 
     btVector3 normal = (t2-t1).cross(t3-t1);
     normal.normalize();
-    m_normals.push_back( normal.angle(n1)>stk_config->m_smooth_angle_limit
-                         ? normal : n1                                     );
-    m_normals.push_back( normal.angle(n2)>stk_config->m_smooth_angle_limit
-                         ? normal : n2                                     );
-    m_normals.push_back( normal.angle(n3)>stk_config->m_smooth_angle_limit
-                         ? normal : n3                                     );
-    m_mesh.addTriangle(t1, t2, t3);
+    d->m_normals.push_back( normal.angle(n1)>stk_config->m_smooth_angle_limit
+                            ? normal : n1                                  );
+    d->m_normals.push_back( normal.angle(n2)>stk_config->m_smooth_angle_limit
+                            ? normal : n2                                  );
+    d->m_normals.push_back( normal.angle(n3)>stk_config->m_smooth_angle_limit
+                            ? normal : n3                                  );
+    d->m_mesh.addTriangle(t1, t2, t3);
 
     // Area of triangle ABC
     btVector3 edge1 = t2 - t1;
     btVector3 edge2 = t3 - t1;
-    m_p1p2p3.push_back(edge1.cross(edge2).length2());
+    d->m_p1p2p3.push_back(edge1.cross(edge2).length2());
 }   // addTriangle
 
+// -----------------------------------------------------------------------------
+/** Returns a hash of all triangles of this mesh (and of the memory layout of
+ *  a bvh in this build), used to find a cached bvh for the same triangles.
+ *  Only the coordinates are hashed, the unused fourth component of each
+ *  vertex is not necessarily initialised.
+ */
+uint64_t TriangleMesh::getContentHash() const
+{
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&hash](const void* data, size_t size)
+    {
+        const uint8_t* p = (const uint8_t*)data;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= p[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+    const uint32_t layout[] = { 1 /* format version */, BT_BULLET_VERSION,
+        (uint32_t)sizeof(void*), (uint32_t)sizeof(btScalar),
+        (uint32_t)sizeof(btOptimizedBvh), (uint32_t)sizeof(btOptimizedBvhNode),
+        (uint32_t)IS_LITTLE_ENDIAN };
+    add(layout, sizeof(layout));
+    const uint32_t num_triangles =
+        (uint32_t)m_data->m_triangleIndex2Material.size();
+    add(&num_triangles, sizeof(num_triangles));
+    for (unsigned int i = 0; i < num_triangles; i++)
+    {
+        btVector3 p[3];
+        getTriangle(i, p, p + 1, p + 2);
+        for (unsigned int j = 0; j < 3; j++)
+            add(p[j].m_floats, 3 * sizeof(btScalar));
+    }
+    return hash;
+}   // getContentHash
+
+// -----------------------------------------------------------------------------
+/** Returns the name of the file in the cache directory which stores the
+ *  bvh of this mesh, to be used in createCollisionShape. It contains a hash
+ *  of the name of the mesh, so files of older versions of the same mesh can
+ *  be found and removed.
+ *  \param name Name identifying this mesh, e.g. the directory of the track.
+ */
+std::string TriangleMesh::getBvhCacheFile(const std::string& name) const
+{
+    // 32-bit FNV-1a
+    uint32_t name_hash = 2166136261U;
+    for (char c : name)
+    {
+        name_hash ^= (uint8_t)c;
+        name_hash *= 16777619U;
+    }
+    char hash[26];
+    snprintf(hash, 26, "%08x-%016llx", name_hash,
+             (unsigned long long)getContentHash());
+    return file_manager->getCachedDataDir() + "bvh-" + hash + ".bin";
+}   // getBvhCacheFile
+
+// -----------------------------------------------------------------------------
+/** Loads a serialized bvh and creates a collision shape using it. Returns
+ *  NULL if the file doesn't exist or is invalid. The file starts with a 16
+ *  bytes header (to keep the alignment of the bvh), followed by the bvh.
+ */
+btBvhTriangleMeshShape* TriangleMesh::loadSerializedBvh(const char* filename)
+{
+    FILE *f = FileUtils::fopenU8Path(filename, "rb");
+    if (!f)
+        return NULL;
+    fseek(f, 0, SEEK_END);
+    long pos = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (pos <= BVH_HEADER_SIZE)
+    {
+        fclose(f);
+        return NULL;
+    }
+
+    void* bytes = btAlignedAlloc(pos, 16);
+    size_t read = fread(bytes, pos, 1, f);
+    fclose(f);
+
+    // Do *NOT* free the bytes on success, 'deSerializeInPlace' makes the
+    // btOptimizedBvh object directly at this memory location
+    btOptimizedBvh* bvh = NULL;
+    if (read == 1 && memcmp(bytes, BVH_HEADER, BVH_HEADER_SIZE) == 0)
+    {
+        bvh = btOptimizedBvh::deSerializeInPlace(
+            (char*)bytes + BVH_HEADER_SIZE,
+            (unsigned int)(pos - BVH_HEADER_SIZE), !IS_LITTLE_ENDIAN);
+    }
+    if (bvh == NULL)
+    {
+        Log::warn("TriangleMesh", "Failed to load serialized BHV '%s'.",
+                  filename);
+        btAlignedFree(bytes);
+        return NULL;
+    }
+    m_data->m_bvh_buffer = bytes;
+    m_data->m_loaded_bvh = bvh;
+
+    btBvhTriangleMeshShape* shape =
+        new btBvhTriangleMeshShape(&m_data->m_mesh,
+                                   false /* useQuantizedAabbCompression */,
+                                   false /* buildBvh */);
+    shape->setOptimizedBvh(bvh);
+    return shape;
+}   // loadSerializedBvh
+
+// -----------------------------------------------------------------------------
+/** Saves the bvh of a collision shape so it can be loaded with
+ *  loadSerializedBvh. The data is written to a temporary file first, so
+ *  another process loading the same track never reads a partial file. Files
+ *  saved for an older version of the same mesh are removed afterwards.
+ */
+void TriangleMesh::saveSerializedBvh(btBvhTriangleMeshShape* shape,
+                                     const char* filename) const
+{
+    btOptimizedBvh* bvh = shape->getOptimizedBvh();
+    unsigned int size = bvh->calculateSerializeBufferSize();
+    char* buffer = (char*)btAlignedAlloc(size + BVH_HEADER_SIZE, 16);
+    memcpy(buffer, BVH_HEADER, BVH_HEADER_SIZE);
+    if (bvh->serialize(buffer + BVH_HEADER_SIZE, size, !IS_LITTLE_ENDIAN))
+    {
+        std::string tmp = StringUtils::insertValues("%s.%d.tmp", filename,
+            (int)StkTime::getMonoTimeMs());
+        FILE* f = FileUtils::fopenU8Path(tmp, "wb");
+        bool success = f != NULL &&
+            fwrite(buffer, size + BVH_HEADER_SIZE, 1, f) == 1;
+        if (f)
+            success &= fclose(f) == 0;
+        if (success && FileUtils::renameU8Path(tmp, filename) == 0)
+        {
+            Log::info("TriangleMesh", "Saved bvh to '%s'.", filename);
+            file_manager->removeOutdatedCachedData(filename);
+        }
+        else if (f)
+            file_manager->removeFile(tmp);
+    }
+    btAlignedFree(buffer);
+}   // saveSerializedBvh
+
+// -----------------------------------------------------------------------------
+/** Deletes the collision shape, and the buffer of its bvh if it was loaded
+ *  from a file. */
+void TriangleMesh::SharedData::freeShape()
+{
+    delete m_shape;
+    m_shape = NULL;
+    if (m_bvh_buffer)
+    {
+        m_loaded_bvh->~btOptimizedBvh();
+        btAlignedFree(m_bvh_buffer);
+        m_bvh_buffer = NULL;
+        m_loaded_bvh = NULL;
+    }
+}   // freeShape
+
 // -----------------------------------------------------------------------------
 /** Creates a collision body only, which can be used for raycasting, but
  *  has no physical properties.
- *  @param serialized_bhv if non-null, load the serialized bhv from file instead
- *                        of builing it on the fly
+ *  @param serialized_bhv if non-null, load the serialized bhv from this file
+ *                        instead of builing it on the fly. If the file
+ *                        doesn't exist (or is outdated), the bhv is built
+ *                        and saved to this file.
  */
 void TriangleMesh::createCollisionShape(bool create_collision_object, const char* serialized_bhv)
 {
-    if(m_triangleIndex2Material.size()==0)
+    if(m_data->m_triangleIndex2Material.size()==0)
     {
         m_collision_shape  = NULL;
         m_motion_state     = NULL;
@@ -103,60 +277,26 @@ void TriangleMesh::createCollisionShape(bool create_collision_object, const char
         m_collision_object = NULL;
         return;
     }
-    // Now convert the triangle mesh into a static rigid body
-    btBvhTriangleMeshShape* bhv_triangle_mesh;
-
-    if (serialized_bhv != NULL)
+    // Now convert the triangle mesh into a static rigid body, unless it was
+    // already done for a mesh sharing the triangles
+    if (!m_data->m_shape)
     {
-        FILE *f = fopen(serialized_bhv, "rb");
-        fseek(f, 0, SEEK_END);
-        long pos = ftell(f);
-        assert(pos != -1L);
-        fseek(f, 0, SEEK_SET);
-
-        void* bytes = btAlignedAlloc(pos, 16);
-        fread(bytes, pos, 1, f);
-        fclose(f);
+        btBvhTriangleMeshShape* bhv_triangle_mesh = NULL;
 
-        btOptimizedBvh* bhv = btOptimizedBvh::deSerializeInPlace(bytes, pos, !IS_LITTLE_ENDIAN);
-        if (bhv == NULL)
-        {
-            Log::warn("TriangleMesh", "Failed to load serialized BHV");
-            bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, false /* useQuantizedAabbCompression */);
-        }
-        else
+        if (serialized_bhv != NULL)
+            bhv_triangle_mesh = loadSerializedBvh(serialized_bhv);
+
+        if (bhv_triangle_mesh == NULL)
         {
-            bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, false /* useQuantizedAabbCompression */,
-                                                           false /* buildBvh */);
-            bhv_triangle_mesh->setOptimizedBvh( bhv );
+            bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_data->m_mesh, false /* useQuantizedAabbCompression */);
+            if (serialized_bhv != NULL)
+                saveSerializedBvh(bhv_triangle_mesh, serialized_bhv);
         }
-        // Do *NOT* free the bytes, 'deSerializeInPlace' makes the btOptimizedBvh object
-        // directly at this memory location
-        //free(bytes);
-
-    }
-    else
-    {
-        bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, false /* useQuantizedAabbCompression */);
-
-        /*
-         // code to serialize triangle mesh
-        btOptimizedBvh* bvh = bhv_triangle_mesh->getOptimizedBvh();
-        unsigned int ssize = bvh->calculateSerializeBufferSize();
-        char* buffer = (char*)btAlignedAlloc(ssize, 16);
-        bool success = bvh->serialize(buffer, ssize, !IS_LITTLE_ENDIAN);
-        printf("serialization success = %i\n", success);
-
-        std::ofstream fileout("/tmp/btOptimizedBvh");
-        fileout.write(buffer, ssize);
-        fileout.close();
-
-        btAlignedFree(buffer);
-         */
+        // No user pointer is set, the shape can outlive this mesh if shared
+        m_data->m_shape = bhv_triangle_mesh;
     }
 
-    m_collision_shape = bhv_triangle_mesh;
-    m_collision_shape->setUserPointer(&m_user_pointer);
+    m_collision_shape = m_data->m_shape;
     if(create_collision_object)
     {
         m_collision_object = new btCollisionObject();
@@ -231,8 +371,10 @@ void TriangleMesh::removeAll()
         delete m_collision_object;
         m_collision_object = NULL;
     }
-    delete m_collision_shape;
+    // The collision shape is kept if another mesh still shares it
     m_collision_shape = NULL;
+    if (m_data.use_count() == 1)
+        m_data->freeShape();
 }   // removeAll
 
 // -----------------------------------------------------------------------------
@@ -315,16 +457,21 @@ btVector3 TriangleMesh::getInterpolatedNormal(unsigned int index,
  *         based on the three normals of the triangle and the location of the
  *         hit point (which is more compute intensive, but results in much
  *         smoother results).
+ *  \param flags If not NULL, the terrain flags of the material hit (0 if
+ *         nothing was hit).
  *  \return True if a triangle was hit, false otherwise (and no output
  *          variable will be set.
  */
 bool TriangleMesh::castRay(const btVector3 &from, const btVector3 &to,
                            btVector3 *xyz, const Material **material,
-                           btVector3 *normal, bool interpolate_normal) const
+                           btVector3 *normal, bool interpolate_normal,
+                           uint16_t *flags) const
 {
     if(!m_collision_shape)
     {
         *material=NULL;
+        if (flags)
+            *flags = 0;
         return false;
     }
 
@@ -384,7 +531,9 @@ bool TriangleMesh::castRay(const btVector3 &from, const btVector3 &to,
     {
         *xyz      = ray_callback.m_hitPointWorld;
         xyz->setW(0.0f);
-        *material = m_triangleIndex2Material[index];
+        *material = m_data->m_triangleIndex2Material[index];
+        if (flags)
+            *flags = m_data->m_triangle_flags[index];
 
         if(normal)
         {
@@ -402,6 +551,8 @@ bool TriangleMesh::castRay(const btVector3 &from, const btVector3 &to,
     else
     {
         *material = NULL;
+        if (flags)
+            *flags = 0;
         if(normal)
             normal->setValue(0, 1, 0);
     }
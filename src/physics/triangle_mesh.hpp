@@ -19,11 +19,14 @@
 #ifndef HEADER_TRIANGLE_MESH_HPP
 #define HEADER_TRIANGLE_MESH_HPP
 
+#include <memory>
+#include <string>
 #include <vector>
 #include "btBulletDynamicsCommon.h"
 
 #include "physics/user_pointer.hpp"
 #include "utils/aligned_array.hpp"
+#include "utils/types.hpp"
 
 class Material;
 
@@ -34,29 +37,67 @@ class Material;
 class TriangleMesh
 {
 private:
+    /** The triangles with their materials and normals, and the collision
+     *  shape (including the bvh) once it is created. This is not changed
+     *  anymore after the collision shape is created, so it can be shared
+     *  between the main and the child process (see shareFrom), only the
+     *  bodies and collision objects are separate. */
+    struct SharedData
+    {
+        std::vector<const Material*> m_triangleIndex2Material;
+
+        /** The terrain flags of the material of each triangle (see
+         *  Material::getTerrainFlags). */
+        std::vector<uint16_t>        m_triangle_flags;
+        btTriangleMesh               m_mesh;
+        btVector3 dummy1, dummy2;
+
+        /** The three normals for each triangle. */
+        AlignedArray<btVector3>      m_normals;
+
+        /** Pre-compute value used in smoothing. */
+        AlignedArray<float>          m_p1p2p3;
+
+        btBvhTriangleMeshShape      *m_shape;
+
+        /** If the bvh was loaded from a file, the buffer it was deserialized
+         *  in (and which it uses), since the collision shape doesn't own
+         *  it. */
+        void                        *m_bvh_buffer;
+
+        /** The deserialized bvh inside m_bvh_buffer. */
+        btOptimizedBvh              *m_loaded_bvh;
+        // --------------------------------------------------------------------
+        SharedData() : m_mesh(), m_shape(NULL), m_bvh_buffer(NULL),
+                       m_loaded_bvh(NULL) {}
+        // --------------------------------------------------------------------
+        ~SharedData()                                        { freeShape(); }
+        // --------------------------------------------------------------------
+        void freeShape();
+    };
+
     UserPointer                  m_user_pointer;
-    std::vector<const Material*> m_triangleIndex2Material;
+    std::shared_ptr<SharedData>  m_data;
     btRigidBody                 *m_body;
     /** Keep track if the physical body was created here or not. */
     bool                         m_free_body;
 
     btCollisionObject           *m_collision_object;
-    btTriangleMesh               m_mesh;
-    btVector3 dummy1, dummy2;
     btDefaultMotionState        *m_motion_state;
+    /** The collision shape in m_data, NULL if not created for this mesh. */
     btCollisionShape            *m_collision_shape;
 
-    /** The three normals for each triangle. */
-    AlignedArray<btVector3>      m_normals;
-
-    /** Pre-compute value used in smoothing. */
-    AlignedArray<float>          m_p1p2p3;
-
     /** If the rigid body can be transformed (which means that normalising
      *  the normals need to update the vertices and normals used according
      *  to the current transform of the body. */
     bool m_can_be_transformed;
 
+    // ------------------------------------------------------------------------
+    btBvhTriangleMeshShape* loadSerializedBvh(const char* filename);
+    // ------------------------------------------------------------------------
+    void saveSerializedBvh(btBvhTriangleMeshShape* shape,
+                           const char* filename) const;
+
 public:
     class RigidBodyTriangleMesh : public btRigidBody
     {
@@ -83,6 +124,8 @@ public:
                             const char* serializedBhv = NULL);
     void removeAll();
     void removeCollisionObject();
+    uint64_t getContentHash() const;
+    std::string getBvhCacheFile(const std::string& name) const;
     btVector3 getInterpolatedNormal(unsigned int index,
                                     const btVector3 &position) const;
     // ------------------------------------------------------------------------
@@ -102,7 +145,11 @@ public:
     const btRigidBody *getBody() const { return m_body; }
     // ------------------------------------------------------------------------
     const Material* getMaterial(int n) const
-                                          {return m_triangleIndex2Material[n];}
+                                  {return m_data->m_triangleIndex2Material[n];}
+    // ------------------------------------------------------------------------
+    /** Returns the terrain flags of the material of the given triangle. */
+    uint16_t getTerrainFlags(int n) const
+                                          {return m_data->m_triangle_flags[n];}
     // ------------------------------------------------------------------------
     const btCollisionShape &getCollisionShape() const
                                           { return *m_collision_shape; }
@@ -111,7 +158,8 @@ public:
     // ------------------------------------------------------------------------
     bool castRay(const btVector3 &from, const btVector3 &to,
                  btVector3 *xyz, const Material **material,
-                 btVector3 *normal=NULL, bool interpolate_normal=false) const;
+                 btVector3 *normal=NULL, bool interpolate_normal=false,
+                 uint16_t *flags=NULL) const;
     // ------------------------------------------------------------------------
     /** Returns the points of the 'indx' triangle.
      *  \param indx Index of the triangle to get.
@@ -119,7 +167,7 @@ public:
     void getTriangle(unsigned int indx, btVector3 *p1, btVector3 *p2,
                      btVector3 *p3) const
     {
-        const IndexedMeshArray &m = m_mesh.getIndexedMeshArray();
+        const IndexedMeshArray &m = m_data->m_mesh.getIndexedMeshArray();
         btVector3 *p = &(((btVector3*)(m[0].m_vertexBase))[3*indx]);
         *p1 = p[0];
         *p2 = p[1];
@@ -132,31 +180,27 @@ public:
     void getNormals(unsigned int indx, btVector3 *n1, 
                     btVector3 *n2, btVector3 *n3) const
     {
-        assert(indx < m_triangleIndex2Material.size());
+        assert(indx < m_data->m_triangleIndex2Material.size());
         unsigned int n = indx*3;
-        *n1 = m_normals[n  ];
-        *n2 = m_normals[n+1];
-        *n3 = m_normals[n+2];
+        *n1 = m_data->m_normals[n  ];
+        *n2 = m_data->m_normals[n+1];
+        *n3 = m_data->m_normals[n+2];
     }   // getNormals
     // ------------------------------------------------------------------------
     /** Returns basically the area of the triangle, which is needed when
      *  smoothing the normals. */
     float getP1P2P3(unsigned int indx) const
     {
-        assert(indx < m_p1p2p3.size());
-        return m_p1p2p3[indx];
+        assert(indx < m_data->m_p1p2p3.size());
+        return m_data->m_p1p2p3[indx];
     }
     // ------------------------------------------------------------------------
-    void copyFrom(const TriangleMesh& tm)
+    /** Uses the triangles (and collision shape once created) of another
+     *  mesh, which must not be changed anymore, instead of copying them. */
+    void shareFrom(const TriangleMesh& tm)
     {
-        for (int i = 0; i < tm.m_mesh.getNumTriangles(); i++)
-        {
-            btVector3 v[6];
-            tm.getTriangle(i, v, v + 1, v + 2);
-            tm.getNormals(i, v + 3, v + 4, v + 5);
-            const Material* m = tm.getMaterial(i);
-            addTriangle(v[0], v[1], v[2], v[3], v[4], v[5], m);
-        }
+        assert(m_data->m_triangleIndex2Material.empty());
+        m_data = tm.m_data;
     }
 };
 #endif
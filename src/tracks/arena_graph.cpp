@@ -21,42 +21,59 @@
 #include "config/user_config.hpp"
 #include "io/file_manager.hpp"
 #include "io/xml_node.hpp"
+#include "network/network_config.hpp"
+#include "network/server_config.hpp"
 #include "race/race_manager.hpp"
 #include "tracks/arena_node.hpp"
 #include "tracks/track.hpp"
 #include "tracks/track_manager.hpp"
+#include "utils/file_utils.hpp"
 #include "utils/log.hpp"
+#include "utils/string_utils.hpp"
+#include "utils/time.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
 #include <queue>
+#include <thread>
+
+/** Header of cached shortest path files. The format version must be
+ *  increased if the content or the computation changes. */
+static const char NAVMESH_HEADER[] = "STK-NAVMESH-1";
+/** Written as uint32 after the header to detect a different byte order. */
+static const uint32_t NAVMESH_BYTE_ORDER = 0x01020304;
+
+const uint16_t ArenaGraph::UNREACHABLE_DISTANCE = 65535;
 
 // -----------------------------------------------------------------------------
 ArenaGraph::ArenaGraph(const std::string &navmesh, const XMLNode *node)
-          : Graph()
+          : Graph(true/*is_arena*/)
 {
     loadNavmesh(navmesh);
-    buildGraph();
-    // Compute shortest distance from all nodes
-    for (unsigned int i = 0; i < getNumNodes(); i++)
-        computeDijkstra(i);
+    // Compute shortest distance from all nodes, or load them if this navmesh
+    // was used before
+    const std::string cache_file = getShortestPathsCacheFile(navmesh);
+    if (!loadShortestPaths(cache_file))
+    {
+        buildGraph();
+        computeAllShortestPaths();
+        saveShortestPaths(cache_file);
+    }
 
     setNearbyNodesOfAllNodes();
+    buildPathTable(NetworkConfig::get()->isNetworking() &&
+                   NetworkConfig::get()->isServer() &&
+                   ServerConfig::m_compact_arena_distances);
     if (node && RaceManager::get()->getMinorMode() == RaceManager::MINOR_MODE_SOCCER)
         loadGoalNodes(node);
 
+    buildSectorGrid();
     loadBoundingBoxNodes();
 
 }   // ArenaGraph
 
-// -----------------------------------------------------------------------------
-ArenaNode* ArenaGraph::getNode(unsigned int i) const
-{
-    assert(i < m_all_nodes.size());
-    ArenaNode* n = dynamic_cast<ArenaNode*>(m_all_nodes[i]);
-    assert(n != NULL);
-    return n;
-}   // getNode
-
 // -----------------------------------------------------------------------------
 void ArenaGraph::differentNodeColor(int n, video::SColor* c) const
 {
@@ -147,13 +164,15 @@ void ArenaGraph::loadNavmesh(const std::string &navmesh)
                         " of quad, will only use the first 4 vertices");
                 }
 
-                createQuad(all_vertices[quad_index[0]],
+                Quad* q = createQuad(all_vertices[quad_index[0]],
                     all_vertices[quad_index[1]], all_vertices[quad_index[2]],
                     all_vertices[quad_index[3]], (int)m_all_nodes.size(),
                     false/*invisible*/, false/*ai_ignore*/, true/*is_arena*/,
                     false/*ignore*/);
 
-                ArenaNode* cur_node = getNode((int)m_all_nodes.size() - 1);
+                // Arena quads are always (3d) arena nodes
+                ArenaNode* cur_node = static_cast<ArenaNode*>(q);
+                m_arena_nodes.push_back(cur_node);
                 cur_node->setAdjacentNodes(adjacent_quad_index);
             }
         }
@@ -179,8 +198,9 @@ void ArenaGraph::buildGraph()
 {
     const unsigned int n_nodes = getNumNodes();
 
-    m_distance_matrix = std::vector<std::vector<float>>
-        (n_nodes, std::vector<float>(n_nodes, 9999.9f));
+    m_distance_matrix.assign(n_nodes * n_nodes, 9999.9f);
+    // Allocate and initialise the previous node data structure:
+    m_parent_node.assign(n_nodes * n_nodes, Graph::UNKNOWN_SECTOR);
     for (unsigned int i = 0; i < n_nodes; i++)
     {
         ArenaNode* cur_node = getNode(i);
@@ -188,25 +208,13 @@ void ArenaGraph::buildGraph()
         {
             Vec3 diff = getNode(adjacent)->getCenter() - cur_node->getCenter();
             float distance = diff.length();
-            m_distance_matrix[i][adjacent] = distance;
+            m_distance_matrix[i * n_nodes + adjacent] = distance;
+            if (adjacent != (int)i)
+                m_parent_node[i * n_nodes + adjacent] = i;
         }
-        m_distance_matrix[i][i] = 0.0f;
+        m_distance_matrix[i * n_nodes + i] = 0.0f;
     }
 
-    // Allocate and initialise the previous node data structure:
-    m_parent_node = std::vector<std::vector<int16_t>>
-        (n_nodes, std::vector<int16_t>(n_nodes, Graph::UNKNOWN_SECTOR));
-    for (unsigned int i = 0; i < n_nodes; i++)
-    {
-        for (unsigned int j = 0; j < n_nodes; j++)
-        {
-            if (i == j || m_distance_matrix[i][j] >= 9899.9f)
-                m_parent_node[i][j] = -1;
-            else
-                m_parent_node[i][j] = i;
-        }   // for j
-    }   // for i
-
 }   // buildGraph
 
 // ----------------------------------------------------------------------------
@@ -216,6 +224,8 @@ void ArenaGraph::buildGraph()
  *  source to j and m_parent_node[source][j] stores the last vertex visited on
  *  the shortest path from i to j before visiting j. Suppose the shortest path
  *  from i to j is i->......->k->j  then m_parent_node[i][j] = k
+ *  Only the row of source is written, and the edge lengths are computed from
+ *  the node centers, so this can be called for different sources in parallel.
  */
 void ArenaGraph::computeDijkstra(int source)
 {
@@ -235,6 +245,8 @@ void ArenaGraph::computeDijkstra(int source)
     IndDistPair begin(source, 0.0f);
     queue.push(begin);
     const unsigned int n = getNumNodes();
+    float* distance = &m_distance_matrix[source * n];
+    int16_t* parent = &m_parent_node[source * n];
     std::vector<bool> visited;
     visited.resize(n, false);
     while (!queue.empty())
@@ -246,24 +258,62 @@ void ArenaGraph::computeDijkstra(int source)
         if (visited[cur_index]) continue;
         visited[cur_index] = true;
 
-        for (const int& adjacent : getNode(cur_index)->getAdjacentNodes())
+        ArenaNode* cur_node = getNode(cur_index);
+        for (const int& adjacent : cur_node->getAdjacentNodes())
         {
             // Distance already computed, can be ignored
             if (visited[adjacent]) continue;
 
-            float new_dist =
-                current.second + m_distance_matrix[cur_index][adjacent];
-            if (new_dist < m_distance_matrix[source][adjacent])
+            // Same as the adjacency matrix set in buildGraph
+            Vec3 diff = getNode(adjacent)->getCenter() - cur_node->getCenter();
+            float new_dist = current.second + diff.length();
+            if (new_dist < distance[adjacent])
             {
-                m_distance_matrix[source][adjacent] = new_dist;
-                m_parent_node[source][adjacent] = cur_index;
+                distance[adjacent] = new_dist;
+                parent[adjacent] = cur_index;
+            }
+            // Longer paths can be skipped. Equal ones can't, since the
+            // distances to the adjacent nodes of source are already set
+            // by buildGraph.
+            if (new_dist <= distance[adjacent])
+            {
+                IndDistPair pair(adjacent, new_dist);
+                queue.push(pair);
             }
-            IndDistPair pair(adjacent, new_dist);
-            queue.push(pair);
         }
     }
 }   // computeDijkstra
 
+// ----------------------------------------------------------------------------
+/** Computes the shortest paths from all nodes by running Dijkstra for each
+ *  node. Navmeshes are sparse graphs, so this is much faster than
+ *  Floyd-Warshall. Large navmeshes use several threads, each computing the
+ *  rows of different nodes.
+ */
+void ArenaGraph::computeAllShortestPaths()
+{
+    const int n = getNumNodes();
+    unsigned int num_threads = std::thread::hardware_concurrency();
+    num_threads = std::min(std::max(num_threads, 1u), 8u);
+    // Not worth starting threads for small navmeshes
+    if (n < 256)
+        num_threads = 1;
+
+    std::atomic<int> next_node(0);
+    auto compute = [this, n, &next_node]()
+    {
+        int source;
+        while ((source = next_node.fetch_add(1)) < n)
+            computeDijkstra(source);
+    };
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < num_threads; i++)
+        threads.emplace_back(compute);
+    compute();
+    for (std::thread& t : threads)
+        t.join();
+}   // computeAllShortestPaths
+
 // ----------------------------------------------------------------------------
 /** THIS FUNCTION IS ONLY USED FOR UNIT-TESTING, to verify that the new
  *  Dijkstra algorithm gives the same results.
@@ -280,16 +330,19 @@ void ArenaGraph::computeFloydWarshall()
 
     for (unsigned int k = 0; k < n; k++)
     {
+        const float* dist_k = &m_distance_matrix[k * n];
+        const int16_t* parent_k = &m_parent_node[k * n];
         for (unsigned int i = 0; i < n; i++)
         {
+            float* dist_i = &m_distance_matrix[i * n];
+            int16_t* parent_i = &m_parent_node[i * n];
+            const float dist_ik = dist_i[k];
             for (unsigned int j = 0; j < n; j++)
             {
-                if ((m_distance_matrix[i][k] + m_distance_matrix[k][j]) <
-                    m_distance_matrix[i][j])
+                if (dist_ik + dist_k[j] < dist_i[j])
                 {
-                    m_distance_matrix[i][j] =
-                        m_distance_matrix[i][k] + m_distance_matrix[k][j];
-                    m_parent_node[i][j] = m_parent_node[k][j];
+                    dist_i[j] = dist_ik + dist_k[j];
+                    parent_i[j] = parent_k[j];
                 }
             }
         }
@@ -297,6 +350,182 @@ void ArenaGraph::computeFloydWarshall()
 
 }   // computeFloydWarshall
 
+// ----------------------------------------------------------------------------
+/** Builds the next node and distance tables from the distance and parent
+ *  matrices, and frees these matrices. The next node on the path from i to
+ *  j is the parent of i on the path from j to i (the graph is undirected),
+ *  so the parent matrix is used as it is.
+ *  \param compact If true, the distances are quantised to 16 bits, with the
+ *         scale chosen so that the longest distance fits. This is accurate
+ *         to a few millimeters even on large arenas.
+ */
+void ArenaGraph::buildPathTable(bool compact)
+{
+    const unsigned int n = getNumNodes();
+    m_next_node.swap(m_parent_node);
+    std::vector<int16_t>().swap(m_parent_node);
+    m_distances.clear();
+    m_compact_distances.clear();
+    m_distance_scale = 1.0f;
+
+    if (compact)
+    {
+        float max_distance = 0.0f;
+        for (float d : m_distance_matrix)
+        {
+            if (d < 9899.9f)
+                max_distance = std::max(max_distance, d);
+        }
+        if (max_distance > 0.0f)
+            m_distance_scale = max_distance / (float)(UNREACHABLE_DISTANCE - 1);
+        m_compact_distances.resize(n * n);
+    }
+    else
+        m_distances.resize(n * n);
+
+    for (unsigned int j = 0; j < n; j++)
+    {
+        for (unsigned int i = 0; i < n; i++)
+        {
+            const float d = m_distance_matrix[i * n + j];
+            if (!compact)
+                m_distances[j * n + i] = d;
+            else
+            {
+                m_compact_distances[j * n + i] = d >= 9899.9f ?
+                    UNREACHABLE_DISTANCE :
+                    (uint16_t)std::min(d / m_distance_scale + 0.5f,
+                                       (float)(UNREACHABLE_DISTANCE - 1));
+            }
+        }
+    }
+    std::vector<float>().swap(m_distance_matrix);
+}   // buildPathTable
+
+// ----------------------------------------------------------------------------
+/** Returns a hash of everything the shortest paths are computed from, i.e.
+ *  the node centers and the adjacent nodes.
+ */
+uint64_t ArenaGraph::getNavmeshHash() const
+{
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&hash](const void* data, size_t size)
+    {
+        const uint8_t* p = (const uint8_t*)data;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= p[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+    const uint32_t n = getNumNodes();
+    add(&n, sizeof(n));
+    for (unsigned int i = 0; i < n; i++)
+    {
+        ArenaNode* node = getNode(i);
+        add(node->getCenter().m_floats, 3 * sizeof(btScalar));
+        const std::vector<int>& adjacent = node->getAdjacentNodes();
+        const uint32_t num_adjacent = (uint32_t)adjacent.size();
+        add(&num_adjacent, sizeof(num_adjacent));
+        if (num_adjacent > 0)
+            add(adjacent.data(), num_adjacent * sizeof(int));
+    }
+    return hash;
+}   // getNavmeshHash
+
+// ----------------------------------------------------------------------------
+/** Returns the name of the file in the cache directory which stores the
+ *  shortest paths of this navmesh. The name contains a hash of the navmesh
+ *  file name, followed by the hash of the navmesh content, so that files
+ *  of an older version of the same navmesh can be found and removed.
+ *  \param navmesh File name of the navmesh.
+ */
+std::string ArenaGraph::getShortestPathsCacheFile(const std::string &navmesh)
+                                                                          const
+{
+    // 32-bit FNV-1a
+    uint32_t name_hash = 2166136261U;
+    for (char c : navmesh)
+    {
+        name_hash ^= (uint8_t)c;
+        name_hash *= 16777619U;
+    }
+    char hash[26];
+    snprintf(hash, 26, "%08x-%016llx", name_hash,
+             (unsigned long long)getNavmeshHash());
+    return file_manager->getCachedDataDir() + "navmesh-" + hash + ".stkcache";
+}   // getShortestPathsCacheFile
+
+// ----------------------------------------------------------------------------
+/** Loads the distance and parent matrices saved by saveShortestPaths.
+ *  Returns false if the file doesn't exist or is invalid. The file starts
+ *  with a header (which also detects a different byte order) and the number
+ *  of nodes, followed by both matrices.
+ */
+bool ArenaGraph::loadShortestPaths(const std::string& filename)
+{
+    FILE *f = FileUtils::fopenU8Path(filename, "rb");
+    if (!f)
+        return false;
+    const unsigned int n = getNumNodes();
+    char header[sizeof(NAVMESH_HEADER)];
+    uint32_t order = 0, num_nodes = 0;
+    std::vector<float> distance_matrix(n * n);
+    std::vector<int16_t> parent_node(n * n);
+    bool success =
+        fread(header, sizeof(header), 1, f) == 1 &&
+        memcmp(header, NAVMESH_HEADER, sizeof(header)) == 0 &&
+        fread(&order, sizeof(order), 1, f) == 1 &&
+        order == NAVMESH_BYTE_ORDER &&
+        fread(&num_nodes, sizeof(num_nodes), 1, f) == 1 && num_nodes == n &&
+        (n == 0 ||
+         (fread(distance_matrix.data(), n * n * sizeof(float), 1, f) == 1 &&
+          fread(parent_node.data(), n * n * sizeof(int16_t), 1, f) == 1));
+    fclose(f);
+    if (!success)
+    {
+        Log::warn("ArenaGraph", "Failed to load shortest paths from '%s'.",
+                  filename.c_str());
+        return false;
+    }
+    m_distance_matrix.swap(distance_matrix);
+    m_parent_node.swap(parent_node);
+    return true;
+}   // loadShortestPaths
+
+// ----------------------------------------------------------------------------
+/** Saves the shortest paths so they can be loaded with loadShortestPaths.
+ *  The data is written to a temporary file first, so another process loading
+ *  the same navmesh never reads a partial file. Files saved for an older
+ *  version of the same navmesh are removed afterwards, otherwise each change
+ *  of a navmesh would leave another file in the cache directory.
+ */
+void ArenaGraph::saveShortestPaths(const std::string& filename) const
+{
+    const uint32_t n = getNumNodes();
+    std::string tmp = StringUtils::insertValues("%s.%d.tmp", filename.c_str(),
+        (int)StkTime::getMonoTimeMs());
+    FILE* f = FileUtils::fopenU8Path(tmp, "wb");
+    if (!f)
+        return;
+    bool success =
+        fwrite(NAVMESH_HEADER, sizeof(NAVMESH_HEADER), 1, f) == 1 &&
+        fwrite(&NAVMESH_BYTE_ORDER, sizeof(NAVMESH_BYTE_ORDER), 1, f) == 1 &&
+        fwrite(&n, sizeof(n), 1, f) == 1 &&
+        (n == 0 ||
+         (fwrite(m_distance_matrix.data(), n * n * sizeof(float), 1, f) == 1 &&
+          fwrite(m_parent_node.data(), n * n * sizeof(int16_t), 1, f) == 1));
+    success &= fclose(f) == 0;
+    if (!success || FileUtils::renameU8Path(tmp, filename) != 0)
+    {
+        file_manager->removeFile(tmp);
+        return;
+    }
+    Log::info("ArenaGraph", "Saved shortest paths to '%s'.", filename.c_str());
+    file_manager->removeOutdatedCachedData(filename);
+}   // saveShortestPaths
+
 // -----------------------------------------------------------------------------
 void ArenaGraph::loadGoalNodes(const XMLNode *node)
 {
@@ -340,25 +569,28 @@ void ArenaGraph::loadGoalNodes(const XMLNode *node)
 void ArenaGraph::setNearbyNodesOfAllNodes()
 {
     // Only save the nearby 8 nodes
-    const unsigned int try_count = 8;
-    for (unsigned int i = 0; i < getNumNodes(); i++)
+    const unsigned int n = getNumNodes();
+    const unsigned int try_count = std::min(8u, n > 0 ? n - 1 : 0);
+    std::vector<int> nodes(n);
+    for (unsigned int i = 0; i < n; i++)
     {
-        // Get the distance to all nodes at i
+        // Sort the nodes by distance to i (nodes with the same distance by
+        // index), skipping the same node
         ArenaNode* cur_node = getNode(i);
-        std::vector<int> nearby_nodes;
-        std::vector<float> dist = m_distance_matrix[i];
-
-        // Skip the same node
-        dist[i] = 999999.0f;
-        for (unsigned int j = 0; j < try_count; j++)
+        const float* dist = &m_distance_matrix[i * n];
+        nodes.clear();
+        for (unsigned int j = 0; j < n; j++)
         {
-            std::vector<float>::iterator it =
-                std::min_element(dist.begin(), dist.end());
-            const int pos = int(it - dist.begin());
-            nearby_nodes.push_back(pos);
-            dist[pos] = 999999.0f;
+            if (j != i)
+                nodes.push_back(j);
         }
-        cur_node->setNearbyNodes(nearby_nodes);
+        std::partial_sort(nodes.begin(), nodes.begin() + try_count,
+                          nodes.end(), [dist](int a, int b)
+            {
+                return dist[a] < dist[b] || (dist[a] == dist[b] && a < b);
+            });
+        cur_node->setNearbyNodes(std::vector<int>(nodes.begin(),
+                                                  nodes.begin() + try_count));
     }
 
 }   // setNearbyNodesOfAllNodes
@@ -368,13 +600,13 @@ void ArenaGraph::setNearbyNodesOfAllNodes()
  *  std::vector (in reverse order). Used only for unit testing.
  */
 std::vector<int16_t> ArenaGraph::getPathFromTo(int from, int to,
-                      const std::vector< std::vector< int16_t > >& parent_node)
+                                const std::vector<int16_t>& parent_node) const
 {
     std::vector<int16_t> path;
     path.push_back(to);
     while(from!=to)
     {
-        to = parent_node[from][to];
+        to = parent_node[from * getNumNodes() + to];
         path.push_back(to);
     }
     return path;
@@ -392,14 +624,43 @@ void ArenaGraph::unitTesting()
     Track *track = track_manager->getTrack("cave");
     std::string navmesh_file_name=track->getTrackFile("navmesh.xml");
 
-    double s = StkTime::getRealTime();
+    // The constructor might load the results from the cache, so compute
+    // them again, and check that they are identical.
     ArenaGraph* ag = new ArenaGraph(navmesh_file_name);
+    std::vector<int16_t> cached_next_node = ag->m_next_node;
+    std::vector<float> cached_distances = ag->m_distances;
+    ag->buildGraph();
+    double s = StkTime::getRealTime();
+    ag->computeAllShortestPaths();
     double e = StkTime::getRealTime();
     Log::error("Time", "Dijkstra       %lf", e-s);
 
     // Save the Dijkstra results
-    std::vector< std::vector< float > > distance_matrix = ag->m_distance_matrix;
-    std::vector< std::vector< int16_t > > parent_node = ag->m_parent_node;
+    std::vector<float> distance_matrix = ag->m_distance_matrix;
+    std::vector<int16_t> parent_node = ag->m_parent_node;
+    const unsigned int n = ag->getNumNodes();
+    ag->buildPathTable(/*compact*/false);
+    if (cached_next_node != ag->m_next_node ||
+        cached_distances != ag->m_distances)
+        Log::error("ArenaGraph", "Cached shortest paths are different.");
+
+    // Check the compact distances
+    ag->m_distance_matrix = distance_matrix;
+    ag->m_parent_node = parent_node;
+    ag->buildPathTable(/*compact*/true);
+    for (unsigned int i = 0; i < n; i++)
+    {
+        for (unsigned int j = 0; j < n; j++)
+        {
+            if (ag->getNextNode(i, j) != parent_node[j*n+i] ||
+                fabsf(ag->getDistance(i, j) - distance_matrix[i*n+j]) >
+                ag->m_distance_scale)
+            {
+                Log::error("ArenaGraph", "Incorrect path table %d, %d.",
+                           i, j);
+            }
+        }
+    }
     ag->buildGraph();
 
     // Now compute results with Floyd-Warshall
@@ -409,15 +670,15 @@ void ArenaGraph::unitTesting()
     Log::error("Time", "Floyd-Warshall %lf", e-s);
 
     int error_count = 0;
-    for(unsigned int i=0; i<ag->m_distance_matrix.size(); i++)
+    for(unsigned int i=0; i<n; i++)
     {
-        for(unsigned int j=0; j<ag->m_distance_matrix[i].size(); j++)
+        for(unsigned int j=0; j<n; j++)
         {
-            if(ag->m_distance_matrix[i][j] - distance_matrix[i][j] > 0.001f)
+            if(ag->m_distance_matrix[i*n+j] - distance_matrix[i*n+j] > 0.001f)
             {
                 Log::error("ArenaGraph",
                            "Incorrect distance %d, %d: Dijkstra: %f F.W.: %f",
-                           i, j, distance_matrix[i][j], ag->m_distance_matrix[i][j]);
+                           i, j, distance_matrix[i*n+j], ag->m_distance_matrix[i*n+j]);
                 error_count++;
             }    // if distance is too different
 
@@ -429,16 +690,16 @@ void ArenaGraph::unitTesting()
             // debugging in the feature
 #undef TEST_PARENT_POLY_EVEN_THOUGH_MANY_FALSE_POSITIVES
 #ifdef TEST_PARENT_POLY_EVEN_THOUGH_MANY_FALSE_POSITIVES
-            if(ag->m_parent_node[i][j] != parent_node[i][j])
+            if(ag->m_parent_node[i*n+j] != parent_node[i*n+j])
             {
                 error_count++;
-                std::vector<int16_t> dijkstra_path = getPathFromTo(i, j, parent_node);
-                std::vector<int16_t> floyd_path = getPathFromTo(i, j, ag->m_parent_node);
+                std::vector<int16_t> dijkstra_path = ag->getPathFromTo(i, j, parent_node);
+                std::vector<int16_t> floyd_path = ag->getPathFromTo(i, j, ag->m_parent_node);
                 if(dijkstra_path.size()!=floyd_path.size())
                 {
                     Log::error("ArenaGraph",
                                "Incorrect path length %d, %d: Dijkstra: %d F.W.: %d",
-                               i, j, parent_node[i][j], ag->m_parent_node[i][j]);
+                               i, j, parent_node[i*n+j], ag->m_parent_node[i*n+j]);
                     continue;
                 }
                 Log::error("ArenaGraph", "Path problems from %d to %d:",
@@ -456,6 +717,9 @@ void ArenaGraph::unitTesting()
         }   // for j
     }   // for i
 
+    // Compare the sector grid with the linear search
+    ag->testSectorGrid(100000);
+
     delete ag;
 
 }   // unitTesting
@@ -21,8 +21,10 @@
 
 #include "tracks/graph.hpp"
 #include "utils/cpp2011.hpp"
+#include "utils/types.hpp"
 
 #include <set>
+#include <string>
 
 class ArenaNode;
 class XMLNode;
@@ -34,11 +36,35 @@ class XMLNode;
 class ArenaGraph : public Graph
 {
 private:
-    /** The actual graph data structure, it is an adjacency matrix. */
-    std::vector<std::vector<float>> m_distance_matrix;
+    /** The same nodes as m_all_nodes, to access them without a cast. */
+    std::vector<ArenaNode*> m_arena_nodes;
 
-    /** The matrix that is used to store computed shortest paths. */
-    std::vector<std::vector<int16_t>> m_parent_node;
+    /** The shortest distances between all nodes, the distance from i to j
+     *  is stored at i * n + j. Before the shortest paths are computed this
+     *  is the adjacency matrix. Only used while loading, freed once
+     *  m_path_table is built. */
+    std::vector<float> m_distance_matrix;
+
+    /** The matrix that is used to store computed shortest paths (in the same
+     *  layout as m_distance_matrix). Only used while loading. */
+    std::vector<int16_t> m_parent_node;
+
+    /** The next node on the shortest path from i to j is stored at
+     *  j * n + i, so the entries used when following a path to the same
+     *  node, or when comparing the distances of several nodes to the same
+     *  node, are close together. */
+    std::vector<int16_t> m_next_node;
+
+    /** The distance from i to j, in the same layout as m_next_node. Empty
+     *  if m_compact_distances is used. */
+    std::vector<float> m_distances;
+
+    /** The distances quantised to 16 bits, in the same layout as
+     *  m_next_node. Only used on servers with compact-arena-distances. */
+    std::vector<uint16_t> m_compact_distances;
+
+    /** Distance represented by one unit of m_compact_distances. */
+    float m_distance_scale;
 
     /** Used in soccer mode to colorize the goal lines in minimap. */
     std::set<int> m_red_node;
@@ -56,17 +82,36 @@ private:
     // ------------------------------------------------------------------------
     void computeDijkstra(int n);
     // ------------------------------------------------------------------------
+    void computeAllShortestPaths();
+    // ------------------------------------------------------------------------
     void computeFloydWarshall();
     // ------------------------------------------------------------------------
-    static std::vector<int16_t> getPathFromTo(int from, int to,
-                     const std::vector< std::vector< int16_t > >& parent_node);
+    void buildPathTable(bool compact);
+    // ------------------------------------------------------------------------
+    uint64_t getNavmeshHash() const;
+    // ------------------------------------------------------------------------
+    std::string getShortestPathsCacheFile(const std::string &navmesh) const;
+    // ------------------------------------------------------------------------
+    bool loadShortestPaths(const std::string& filename);
+    // ------------------------------------------------------------------------
+    void saveShortestPaths(const std::string& filename) const;
+    // ------------------------------------------------------------------------
+    std::vector<int16_t> getPathFromTo(int from, int to,
+                               const std::vector<int16_t>& parent_node) const;
     // ------------------------------------------------------------------------
     virtual bool hasLapLine() const OVERRIDE                  { return false; }
     // ------------------------------------------------------------------------
     virtual void differentNodeColor(int n, video::SColor* c) const OVERRIDE;
 
+    /** Quantised distance of nodes which are not connected. */
+    static const uint16_t UNREACHABLE_DISTANCE;
+
 public:
-    static ArenaGraph* get()     { return dynamic_cast<ArenaGraph*>(m_graph); }
+    static ArenaGraph* get()
+    {
+        return m_graph && m_graph->isArena() ?
+            static_cast<ArenaGraph*>(m_graph) : NULL;
+    }   // get
     // ------------------------------------------------------------------------
     static void unitTesting();
     // ------------------------------------------------------------------------
@@ -74,25 +119,31 @@ public:
     // ------------------------------------------------------------------------
     virtual ~ArenaGraph() {}
     // ------------------------------------------------------------------------
-    ArenaNode* getNode(unsigned int i) const;
+    ArenaNode* getNode(unsigned int i) const
+    {
+        assert(i < m_arena_nodes.size());
+        return m_arena_nodes[i];
+    }
     // ------------------------------------------------------------------------
-    /** Returns the next node on the shortest path from i to j.
-     *  Note: m_parent_node[j][i] contains the parent of i on path from j to i,
-     *  which is the next node on the path from i to j (undirected graph)
-     */
+    /** Returns the next node on the shortest path from i to j. */
     int getNextNode(int i, int j) const
     {
         if (i == Graph::UNKNOWN_SECTOR || j == Graph::UNKNOWN_SECTOR)
             return Graph::UNKNOWN_SECTOR;
-        return (int)(m_parent_node[j][i]);
+        return m_next_node[j * getNumNodes() + i];
     }
     // ------------------------------------------------------------------------
-    /** Returns the distance between any two nodes */
+    /** Returns the distance between any two nodes. With compact distances
+     *  the error is at most half of the distance scale. */
     float getDistance(int from, int to) const
     {
         if (from == Graph::UNKNOWN_SECTOR || to == Graph::UNKNOWN_SECTOR)
             return 99999.0f;
-        return m_distance_matrix[from][to];
+        const unsigned int index = to * getNumNodes() + from;
+        if (!m_distances.empty())
+            return m_distances[index];
+        const uint16_t d = m_compact_distances[index];
+        return d == UNREACHABLE_DISTANCE ? 9999.9f : d * m_distance_scale;
     }
 
 };   // ArenaGraph
@@ -21,6 +21,8 @@
 
 #include "utils/vec3.hpp"
 
+#include <cmath>
+
 /**
   * \ingroup tracks
   */
@@ -68,16 +70,92 @@ public:
     // ------------------------------------------------------------------------
     bool pointInside(const Vec3& p, bool ignore_vertical = false) const
     {
-        float side = p.sideofPlane(m_box_faces[0][0], m_box_faces[0][1],
-            m_box_faces[0][2]);
-        for (int i = 1; i < 6; i++)
+        // Take the side from the first face the point is not on, otherwise
+        // all points on the plane of the first face would be inside.
+        float side = 0.0f;
+        for (int i = 0; i < 6; i++)
         {
-            if (side * p.sideofPlane(m_box_faces[i][0], m_box_faces[i][1],
-                m_box_faces[i][2]) < 0)
+            float s = p.sideofPlane(m_box_faces[i][0], m_box_faces[i][1],
+                m_box_faces[i][2]);
+            if (side * s < 0)
                 return false;
+            if (side == 0.0f)
+                side = s;
         }
         return true;
     }
+    // ------------------------------------------------------------------------
+    /** Computes an axis aligned box containing all points for which
+     *  pointInside returns true. If the quad is not planar, the top and
+     *  bottom faces are tilted against each other, and pointInside can then
+     *  accept points far away from the quad.
+     *  \param min On return the minimum corner of the box.
+     *  \param max On return the maximum corner of the box.
+     *  \return False if the accepted points are not bounded.
+     */
+    bool getExtent(Vec3 *min, Vec3 *max) const
+    {
+        Vec3 n[6];
+        float d[6];
+        for (int i = 0; i < 6; i++)
+        {
+            n[i] = (m_box_faces[i][1] - m_box_faces[i][0])
+                   .cross(m_box_faces[i][2] - m_box_faces[i][0]);
+            d[i] = n[i].dot(m_box_faces[i][0]);
+        }
+        *min = Vec3( 999999.9f);
+        *max = Vec3(-999999.9f);
+        // pointInside accepts all points on the positive side of all
+        // planes, and all points on the negative side of all planes.
+        for (float sign = -1.0f; sign <= 1.0f; sign += 2.0f)
+        {
+            for (int i = 0; i < 6; i++)
+            {
+                for (int j = i + 1; j < 6; j++)
+                {
+                    // The region is unbounded if a direction moves away
+                    // from (or parallel to) all planes. Such a direction
+                    // lies on an edge of the cone of these directions.
+                    Vec3 dir = n[i].cross(n[j]);
+                    for (float dir_sign = -1.0f; dir_sign <= 1.0f;
+                         dir_sign += 2.0f)
+                    {
+                        bool unbounded = dir.length2() > 0.0f;
+                        for (int k = 0; k < 6 && unbounded; k++)
+                        {
+                            unbounded = sign * dir_sign * n[k].dot(dir) >=
+                                -0.0001f * n[k].length() * dir.length();
+                        }
+                        if (unbounded)
+                            return false;
+                    }
+                    // Otherwise the region is the convex hull of the
+                    // intersection points of three planes inside of it.
+                    for (int k = j + 1; k < 6; k++)
+                    {
+                        float det = n[i].dot(n[j].cross(n[k]));
+                        if (fabsf(det) < 0.000001f)
+                            continue;
+                        Vec3 p = (d[i] * n[j].cross(n[k]) +
+                                  d[j] * n[k].cross(n[i]) +
+                                  d[k] * n[i].cross(n[j])) / det;
+                        bool inside = true;
+                        for (int l = 0; l < 6 && inside; l++)
+                        {
+                            inside = sign * (n[l].dot(p) - d[l]) >=
+                                     -0.001f * n[l].length();
+                        }
+                        if (inside)
+                        {
+                            min->min(p);
+                            max->max(p);
+                        }
+                    }   // for k
+                }   // for j
+            }   // for i
+        }   // for sign
+        return true;
+    }   // getExtent
 
 };
 
@@ -143,7 +143,8 @@ void CheckCannon::update(float dt)
 
         const Vec3& xyz = world->getKart(i)->getFrontXYZ();
         Vec3 prev_xyz = xyz - kart->getVelocity() * dt;
-        if (isTriggered(prev_xyz, xyz, /*kart index - ignore*/ -1))
+        if (mightBeTriggered(prev_xyz, xyz) &&
+            isTriggered(prev_xyz, xyz, /*kart index - ignore*/ -1))
         {
             // The constructor AbstractKartAnimation resets the skidding to 0.
             // So in order to smooth rotate the kart, we need to keep the
@@ -160,6 +161,8 @@ void CheckCannon::update(float dt)
 
         const Vec3 current_position = flyable->getXYZ();
         Vec3 previous_position = current_position - flyable->getVelocity() * dt;
+        if (!mightBeTriggered(previous_position, current_position))
+            continue;
 
         setIgnoreHeight(true);
         bool triggered = isTriggered(previous_position, current_position,
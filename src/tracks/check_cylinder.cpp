@@ -18,6 +18,7 @@
 
 #include "tracks/check_cylinder.hpp"
 
+#include <cmath>
 #include <string>
 #include <stdio.h>
 
@@ -36,6 +37,11 @@ CheckCylinder::CheckCylinder(const XMLNode &node,
     node.get("radius", &m_radius2);
     m_radius2 *= m_radius2;
     node.get("xyz", &m_center_point);
+    const float radius = sqrtf(m_radius2);
+    setBoundingBox(m_center_point.getX() - radius,
+                   m_center_point.getZ() - radius,
+                   m_center_point.getX() + radius,
+                   m_center_point.getZ() + radius);
     unsigned int num_karts = RaceManager::get()->getNumberOfKarts();
     m_is_inside.resize(num_karts);
     m_distance2.resize(num_karts);
@@ -79,3 +85,19 @@ bool CheckCylinder::isTriggered(const Vec3 &old_pos, const Vec3 &new_pos,
 
     return triggered;
 }   // isTriggered
+
+// ----------------------------------------------------------------------------
+/** Called instead of isTriggered if the kart is not close to this cylinder,
+ *  i.e. it is outside of the cylinder in the previous and current frame.
+ *  \param new_pos  Position in current frame.
+ *  \param kart_id  Index of the kart.
+ */
+void CheckCylinder::notTriggered(const Vec3 &new_pos, int kart_id)
+{
+    if (kart_id < 0 || kart_id >= (int)m_is_inside.size())
+        return;
+    const float dx = new_pos.getX() - m_center_point.getX();
+    const float dz = new_pos.getZ() - m_center_point.getZ();
+    m_is_inside[kart_id] = false;
+    m_distance2[kart_id] = dx * dx + dz * dz;
+}   // notTriggered
@@ -74,6 +74,8 @@ CheckLine::CheckLine(const XMLNode &node,  unsigned int index)
         m_min_height = std::min(m_left_point.getY(), m_right_point.getY());
     }
     m_line.setLine(p1, p2);
+    setBoundingBox(std::min(p1.X, p2.X), std::min(p1.Y, p2.Y),
+                   std::max(p1.X, p2.X), std::max(p1.Y, p2.Y));
     if(UserConfigParams::m_check_debug && !GUIEngine::isNoGraphics())
     {
 #ifndef SERVER_ONLY
@@ -219,6 +221,21 @@ bool CheckLine::isTriggered(const Vec3 &old_pos, const Vec3 &new_pos,
     return result;
 }   // isTriggered
 
+// ----------------------------------------------------------------------------
+/** Called instead of isTriggered if the kart is not close to this line, only
+ *  updates the side of the line the kart is on.
+ *  \param new_pos   Position in current frame.
+ *  \param kart_indx Index of the kart.
+ */
+void CheckLine::notTriggered(const Vec3 &new_pos, int kart_index)
+{
+    if (kart_index >= 0)
+    {
+        core::vector2df p = new_pos.toIrrVector2d();
+        m_previous_sign[kart_index] = m_line.getPointOrientation(p) >= 0;
+    }
+}   // notTriggered
+
 // ----------------------------------------------------------------------------
 void CheckLine::saveCompleteState(BareNetworkString* bns)
 {
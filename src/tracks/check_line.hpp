@@ -87,6 +87,7 @@ public:
     virtual     ~CheckLine();
     virtual bool isTriggered(const Vec3 &old_pos, const Vec3 &new_pos,
                              int indx) OVERRIDE;
+    virtual void notTriggered(const Vec3 &new_pos, int indx) OVERRIDE;
     virtual void reset(const Track &track) OVERRIDE;
     virtual void resetAfterKartMove(unsigned int kart_index) OVERRIDE;
     virtual void resetAfterRewind(unsigned int kart_index) OVERRIDE
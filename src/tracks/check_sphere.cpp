@@ -18,6 +18,7 @@
 
 #include "tracks/check_sphere.hpp"
 
+#include <cmath>
 #include <string>
 #include <stdio.h>
 
@@ -38,6 +39,11 @@ CheckSphere::CheckSphere(const XMLNode &node, unsigned int index)
     node.get("radius", &m_radius2);
     m_radius2 *= m_radius2;
     node.get("xyz", &m_center_point);
+    const float radius = sqrtf(m_radius2);
+    setBoundingBox(m_center_point.getX() - radius,
+                   m_center_point.getZ() - radius,
+                   m_center_point.getX() + radius,
+                   m_center_point.getZ() + radius);
     unsigned int num_karts = RaceManager::get()->getNumberOfKarts();
     m_is_inside.resize(num_karts);
     m_distance2.resize(num_karts);
@@ -71,3 +77,17 @@ bool CheckSphere::isTriggered(const Vec3 &old_pos, const Vec3 &new_pos,
     return (old_dist2>=m_radius2 && new_dist2 < m_radius2) ||
            (old_dist2< m_radius2 && new_dist2 >=m_radius2);
 }   // isTriggered
+
+// ----------------------------------------------------------------------------
+/** Called instead of isTriggered if the kart is not close to this sphere,
+ *  i.e. it is outside of the sphere in the previous and current frame.
+ *  \param new_pos  Position in current frame.
+ *  \param kart_id  Index of the kart.
+ */
+void CheckSphere::notTriggered(const Vec3 &new_pos, int kart_id)
+{
+    if (kart_id < 0 || kart_id >= (int)m_is_inside.size())
+        return;
+    m_is_inside[kart_id] = false;
+    m_distance2[kart_id] = (new_pos-m_center_point).length2();
+}   // notTriggered
@@ -36,6 +36,7 @@ CheckStructure::CheckStructure(const XMLNode &node, unsigned int index)
 {
     m_index              = index;
     m_check_type         = CT_NEW_LAP;
+    m_has_bounding_box   = false;
 
     // This structure is actually filled by the check manager (necessary
     // in order to support track reversing).
@@ -79,10 +80,27 @@ CheckStructure::CheckStructure()
               : m_active_at_reset(true),
                 m_index(Track::getCurrentTrack()->getCheckManager()
                 ->getCheckStructureCount()),
-                m_check_type(CT_TRIGGER)
+                m_check_type(CT_TRIGGER),
+                m_has_bounding_box(false)
 {
 }   // CheckStructure
 
+// ----------------------------------------------------------------------------
+/** Sets the bounding box in the XZ plane, outside of which this check
+ *  structure can't be triggered. A small margin is added so that rounding
+ *  errors in the exact tests can't make a difference.
+ */
+void CheckStructure::setBoundingBox(float min_x, float min_z,
+                                    float max_x, float max_z)
+{
+    const float margin = 0.1f;
+    m_min_x            = min_x - margin;
+    m_min_z            = min_z - margin;
+    m_max_x            = max_x + margin;
+    m_max_z            = max_z + margin;
+    m_has_bounding_box = true;
+}   // setBoundingBox
+
 // ----------------------------------------------------------------------------
 /** Initialises the 'previous positions' of all karts with the start position
  *  defined for this track.
@@ -116,8 +134,13 @@ void CheckStructure::update(float dt)
     {
         const Vec3 &xyz = world->getKart(i)->getFrontXYZ();
         if(world->getKart(i)->getKartAnimation()) continue;
-        // Only check active checklines.
-        if(m_is_active[i] && isTriggered(m_previous_position[i], xyz, i))
+        // Only check active checklines, and skip the exact test if the kart
+        // is not close to this check structure.
+        if(m_is_active[i] && !mightBeTriggered(m_previous_position[i], xyz))
+        {
+            notTriggered(xyz, i);
+        }
+        else if(m_is_active[i] && isTriggered(m_previous_position[i], xyz, i))
         {
             if(UserConfigParams::m_check_debug)
                 Log::info("CheckStructure",
@@ -19,6 +19,7 @@
 #ifndef HEADER_CHECK_STRUCTURE_HPP
 #define HEADER_CHECK_STRUCTURE_HPP
 
+#include <algorithm>
 #include <vector>
 
 #include "utils/aligned_array.hpp"
@@ -85,6 +86,7 @@ protected:
 
     /** For CheckTrigger or CheckCylinder */
     CheckStructure();
+    void setBoundingBox(float min_x, float min_z, float max_x, float max_z);
 private:
     /** The type of this checkline. */
     CheckType         m_check_type;
@@ -100,6 +102,14 @@ private:
      *  as huge shortcuts. */
     std::vector<int> m_same_group;
 
+    /** True if this check structure has a bounding box, which allows
+     *  update to skip isTriggered for karts which are not close to it. */
+    bool             m_has_bounding_box;
+
+    /** Bounding box in the XZ plane of everything that can trigger this
+     *  check structure, only used if m_has_bounding_box is set. */
+    float            m_min_x, m_min_z, m_max_x, m_max_z;
+
     enum ChangeState {CS_DEACTIVATE, CS_ACTIVATE, CS_TOGGLE};
 
     void changeStatus(const std::vector<int> &indices, int kart_index,
@@ -121,9 +131,31 @@ public:
      */
     virtual bool isTriggered(const Vec3 &old_pos, const Vec3 &new_pos,
                              int indx)=0;
+    /** Called by update instead of isTriggered if the bounding box shows
+     *  that going from the previous position to new_pos can't trigger this
+     *  check structure. Must update the kart specific data the same way
+     *  isTriggered would.
+     *  \param new_pos Position in current frame.
+     *  \param indx    Index of the kart.
+     */
+    virtual void notTriggered(const Vec3 &new_pos, int indx) {}
     virtual void trigger(unsigned int kart_index);
     virtual void reset(const Track &track);
 
+    // ------------------------------------------------------------------------
+    /** Cheap test if going from old_pos to new_pos can trigger this check
+     *  structure, i.e. if the bounding box of the movement overlaps the
+     *  bounding box of this check structure. */
+    bool mightBeTriggered(const Vec3 &old_pos, const Vec3 &new_pos) const
+    {
+        if (!m_has_bounding_box)
+            return true;
+        return std::max(old_pos.getX(), new_pos.getX()) >= m_min_x &&
+               std::min(old_pos.getX(), new_pos.getX()) <= m_max_x &&
+               std::max(old_pos.getZ(), new_pos.getZ()) >= m_min_z &&
+               std::min(old_pos.getZ(), new_pos.getZ()) <= m_max_z;
+    }   // mightBeTriggered
+
     // ------------------------------------------------------------------------
     /** Returns the type of this check structure. */
     CheckType getType() const { return m_check_type; }
@@ -29,7 +29,63 @@
 #include "tracks/check_manager.hpp"
 #include "tracks/drive_node.hpp"
 #include "tracks/track.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/log.hpp"
 #include "utils/string_utils.hpp"
+#include "utils/time.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+/** Header of cached drive graph files. The format version must be increased
+ *  if the content or the computation changes. */
+static const char DRIVELINE_HEADER[] = "STK-DRIVELINE-1";
+/** Written as uint32 after the header to detect a different byte order. */
+static const uint32_t DRIVELINE_BYTE_ORDER = 0x01020304;
+
+// ----------------------------------------------------------------------------
+/** Adds data to a 64-bit FNV-1a hash. */
+static void hashData(const void* data, size_t size, uint64_t* hash)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        *hash ^= p[i];
+        *hash *= 1099511628211ULL;
+    }
+}   // hashData
+
+// ----------------------------------------------------------------------------
+/** Adds the content of a file to a hash, returns false if the file can't be
+ *  read. */
+static bool hashFile(const std::string& filename, uint64_t* hash)
+{
+    FILE* f = FileUtils::fopenU8Path(filename, "rb");
+    if (!f)
+        return false;
+    char buffer[4096];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), f)) > 0)
+        hashData(buffer, size, hash);
+    const bool success = ferror(f) == 0;
+    fclose(f);
+    return success;
+}   // hashFile
+
+// ----------------------------------------------------------------------------
+template<typename T>
+static bool readVector(FILE* f, std::vector<T>* v)
+{
+    return v->empty() || fread(v->data(), v->size() * sizeof(T), 1, f) == 1;
+}   // readVector
+
+// ----------------------------------------------------------------------------
+template<typename T>
+static bool writeVector(FILE* f, const std::vector<T>& v)
+{
+    return v.empty() || fwrite(v.data(), v.size() * sizeof(T), 1, f) == 1;
+}   // writeVector
 
 // ----------------------------------------------------------------------------
 /** Constructor, loads the graph information for a given set of quads
@@ -39,7 +95,8 @@
  */
 DriveGraph::DriveGraph(const std::string &quad_file_name,
                        const std::string &graph_file_name,
-                       const bool reverse) : m_reverse(reverse)
+                       const bool reverse)
+          : Graph(false/*is_arena*/), m_reverse(reverse)
 {
     m_lap_length    = 0;
     m_quad_filename = quad_file_name;
@@ -51,9 +108,10 @@ DriveGraph::DriveGraph(const std::string &quad_file_name,
 void DriveGraph::addSuccessor(unsigned int from, unsigned int to)
 {
     if(m_reverse)
-        getNode(to)->addSuccessor(from);
-    else
-        getNode(from)->addSuccessor(to);
+        std::swap(from, to);
+    getNode(from)->addSuccessor(to);
+    m_edges.push_back(from);
+    m_edges.push_back(to);
 
 }   // addSuccessor
 
@@ -85,13 +143,22 @@ void DriveGraph::getPoint(const XMLNode *xml,
 }   // getPoint
 
 // ----------------------------------------------------------------------------
-/** Loads a drive graph from a file.
+/** Loads a drive graph from a file, or from the cache if the same files were
+ *  loaded before.
  *  \param filename Name of the quad file to load.
  *  \param filename Name of the graph file to load.
  */
 void DriveGraph::load(const std::string &quad_file_name,
                       const std::string &filename)
 {
+    const std::string cache_file = getCacheFile(quad_file_name, filename);
+    if (!cache_file.empty() && loadCache(cache_file))
+    {
+        buildSectorGrid();
+        loadBoundingBoxNodes();
+        return;
+    }
+
     XMLNode *quad = file_manager->createXMLTree(quad_file_name);
     if (!quad || quad->getName() != "quads")
     {
@@ -151,8 +218,10 @@ void DriveGraph::load(const std::string &quad_file_name,
             ai_ignore = true;
         }
 
-        createQuad(p0, p1, p2, p3, (unsigned int)m_all_nodes.size(), invisible, ai_ignore,
-                   false/*is_arena*/, ignored);
+        Quad* q = createQuad(p0, p1, p2, p3, (unsigned int)m_all_nodes.size(),
+                             invisible, ai_ignore, false/*is_arena*/, ignored);
+        // Drive quads are always (2d or 3d) drive nodes
+        m_drive_nodes.push_back(static_cast<DriveNode*>(q));
     }
     for (unsigned i = 0; i < m_all_nodes.size(); i++)
     {
@@ -180,6 +249,8 @@ void DriveGraph::load(const std::string &quad_file_name,
             Log::error("DriveGraph", "No node in driveline graph.");
             m_lap_length = 10.0f;
         }
+        setupPaths();
+        std::vector<int>().swap(m_edges);
 
         return;
     }
@@ -259,11 +330,442 @@ void DriveGraph::load(const std::string &quad_file_name,
         if(l > m_lap_length)
             m_lap_length = l;
     }
+    setupPaths();
 
+    if (!cache_file.empty())
+        saveCache(cache_file);
+    std::vector<int>().swap(m_edges);
+
+    buildSectorGrid();
     loadBoundingBoxNodes();
 
 }   // load
 
+// ----------------------------------------------------------------------------
+/** Returns the name of the file in the cache directory which stores the
+ *  drive graph loaded from the given files, or an empty string if a file
+ *  can't be read (e.g. if there is no graph file). The name contains a hash
+ *  of the quad file name and the reverse mode, so outdated files of the same
+ *  track can be removed, and a hash of the content of both files, so a
+ *  changed track uses a new file.
+ */
+std::string DriveGraph::getCacheFile(const std::string &quad_file_name,
+                                     const std::string &graph_file_name) const
+{
+    const uint8_t reverse[2] = { m_reverse,
+                                 RaceManager::get()->getReverseTrack() };
+    // 32-bit FNV-1a
+    uint32_t name_hash = 2166136261U;
+    const std::string name = quad_file_name +
+                             std::string((const char*)reverse, 2);
+    for (char c : name)
+    {
+        name_hash ^= (uint8_t)c;
+        name_hash *= 16777619U;
+    }
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    hashData(reverse, sizeof(reverse), &hash);
+    if (!hashFile(quad_file_name, &hash) || !hashFile(graph_file_name, &hash))
+        return "";
+    char hash_string[26];
+    snprintf(hash_string, 26, "%08x-%016llx", name_hash,
+             (unsigned long long)hash);
+    return file_manager->getCachedDataDir() + "driveline-" + hash_string +
+           ".stkcache";
+}   // getCacheFile
+
+// ----------------------------------------------------------------------------
+/** Creates all drive nodes from a file saved by saveCache. Returns false
+ *  (without creating any node) if the file doesn't exist or is invalid.
+ *  After the header and the sizes the file contains flat arrays: the points
+ *  and flags of all quads, the distances from start, the edges, the
+ *  direction data of each edge and the paths of all nodes with more than
+ *  one successor.
+ */
+bool DriveGraph::loadCache(const std::string &filename)
+{
+    FILE *f = FileUtils::fopenU8Path(filename, "rb");
+    if (!f)
+        return false;
+    char header[sizeof(DRIVELINE_HEADER)];
+    uint32_t order = 0, n = 0, num_edges = 0;
+    // Min and max height testing, lap length
+    float values[3];
+    bool success =
+        fread(header, sizeof(header), 1, f) == 1 &&
+        memcmp(header, DRIVELINE_HEADER, sizeof(header)) == 0 &&
+        fread(&order, sizeof(order), 1, f) == 1 &&
+        order == DRIVELINE_BYTE_ORDER &&
+        fread(&n, sizeof(n), 1, f) == 1 &&
+        fread(&num_edges, sizeof(num_edges), 1, f) == 1 &&
+        fread(values, sizeof(values), 1, f) == 1 &&
+        n > 0 && n < 65536;
+    if (success)
+    {
+        // Each edge stores two nodes, its direction and its last index. Check
+        // that the file is large enough for them before allocating the
+        // arrays, since a broken file could contain any number of edges.
+        const long start = ftell(f);
+        success = start >= 0 && fseek(f, 0, SEEK_END) == 0;
+        const long size = ftell(f);
+        success = success && size >= start &&
+            (uint64_t)num_edges * 4 * sizeof(int32_t) <=
+                (uint64_t)(size - start) &&
+            fseek(f, start, SEEK_SET) == 0;
+    }
+
+    std::vector<float> points, distances;
+    std::vector<uint8_t> flags;
+    std::vector<int32_t> edges, directions, paths;
+    std::vector<uint32_t> last_index;
+    std::vector<unsigned int> num_successors;
+    if (success)
+    {
+        points.resize(n * 12);
+        flags.resize(n);
+        distances.resize(n);
+        edges.resize(num_edges * 2);
+        directions.resize(num_edges);
+        last_index.resize(num_edges);
+        success = readVector(f, &points) && readVector(f, &flags) &&
+                  readVector(f, &distances) && readVector(f, &edges) &&
+                  readVector(f, &directions) && readVector(f, &last_index);
+    }
+    if (success)
+    {
+        num_successors.resize(n, 0);
+        for (unsigned int i = 0; i < num_edges; i++)
+        {
+            if (edges[2 * i] < 0 || edges[2 * i] >= (int)n ||
+                edges[2 * i + 1] < 0 || edges[2 * i + 1] >= (int)n ||
+                directions[i] < 0 ||
+                directions[i] >= DriveNode::DIR_UNDEFINED ||
+                last_index[i] >= n)
+            {
+                success = false;
+                break;
+            }
+            num_successors[edges[2 * i]]++;
+        }
+    }
+    if (success)
+    {
+        unsigned int num_branches = 0;
+        for (unsigned int i = 0; i < n; i++)
+        {
+            if (num_successors[i] > 1)
+                num_branches++;
+        }
+        paths.resize(num_branches * n);
+        success = readVector(f, &paths);
+    }
+    if (success)
+    {
+        // Each path entry is the index of the successor to use, or -1 if
+        // the node can't be reached
+        unsigned int branch = 0;
+        for (unsigned int i = 0; i < n && success; i++)
+        {
+            if (num_successors[i] < 2)
+                continue;
+            for (unsigned int j = 0; j < n; j++)
+            {
+                const int path = paths[branch * n + j];
+                if (path < -1 || path >= (int)num_successors[i])
+                {
+                    success = false;
+                    break;
+                }
+            }
+            branch++;
+        }
+    }
+    fclose(f);
+    if (!success)
+    {
+        Log::warn("DriveGraph", "Failed to load drive graph from '%s'.",
+                  filename.c_str());
+        return false;
+    }
+
+    for (unsigned int i = 0; i < n; i++)
+    {
+        const float* p = &points[i * 12];
+        Quad* q = createQuad(Vec3(p[0], p[1],  p[2]), Vec3(p[3], p[4],  p[5]),
+                             Vec3(p[6], p[7],  p[8]), Vec3(p[9], p[10], p[11]),
+                             i, (flags[i] & 1) != 0, (flags[i] & 2) != 0,
+                             false/*is_arena*/, (flags[i] & 4) != 0);
+        q->setHeightTesting(values[0], values[1]);
+        m_drive_nodes.push_back(static_cast<DriveNode*>(q));
+    }
+    // Adding the edges in the same order also restores the order of the
+    // predecessors
+    for (unsigned int i = 0; i < num_edges; i++)
+        getNode(edges[2 * i])->addSuccessor(edges[2 * i + 1]);
+
+    unsigned int edge = 0, branch = 0;
+    for (unsigned int i = 0; i < n; i++)
+    {
+        DriveNode* dn = getNode(i);
+        dn->setDistanceFromStart(distances[i]);
+        for (unsigned int j = 0; j < dn->getNumberOfSuccessors(); j++)
+        {
+            dn->setDirectionData(j,
+                (DriveNode::DirectionType)directions[edge], last_index[edge]);
+            edge++;
+        }
+        if (dn->getNumberOfSuccessors() > 1)
+        {
+            dn->setPathsToNode(std::vector<int>(paths.begin() + branch * n,
+                paths.begin() + (branch + 1) * n));
+            branch++;
+        }
+    }
+    m_lap_length = values[2];
+    return true;
+}   // loadCache
+
+// ----------------------------------------------------------------------------
+/** Saves the drive graph so it can be loaded with loadCache. The data is
+ *  written to a temporary file first, so another process loading the same
+ *  track never reads a partial file.
+ */
+void DriveGraph::saveCache(const std::string &filename) const
+{
+    const uint32_t n = getNumNodes();
+    const uint32_t num_edges = (uint32_t)m_edges.size() / 2;
+    if (n == 0 || n >= 65536)
+        return;
+
+    std::vector<float> points, distances;
+    std::vector<uint8_t> flags;
+    std::vector<int32_t> edges(m_edges.begin(), m_edges.end());
+    std::vector<int32_t> directions, paths;
+    std::vector<uint32_t> last_index;
+    float min_height_testing = 0.0f, max_height_testing = 0.0f;
+    for (unsigned int i = 0; i < n; i++)
+    {
+        const DriveNode* dn = getNode(i);
+        for (unsigned int j = 0; j < 4; j++)
+        {
+            points.push_back((*dn)[j].getX());
+            points.push_back((*dn)[j].getY());
+            points.push_back((*dn)[j].getZ());
+        }
+        flags.push_back((dn->isInvisible() ? 1 : 0) |
+                        (dn->letAIIgnore() ? 2 : 0) |
+                        (dn->isIgnored()   ? 4 : 0));
+        distances.push_back(dn->getDistanceFromStart());
+        for (unsigned int j = 0; j < dn->getNumberOfSuccessors(); j++)
+        {
+            DriveNode::DirectionType dir;
+            unsigned int last;
+            dn->getDirectionData(j, &dir, &last);
+            directions.push_back(dir);
+            last_index.push_back(last);
+        }
+        if (dn->getNumberOfSuccessors() > 1)
+        {
+            const std::vector<int>& p = dn->getPathsToNode();
+            paths.insert(paths.end(), p.begin(), p.end());
+        }
+        min_height_testing = dn->getMinHeightTesting();
+        max_height_testing = dn->getMaxHeightTesting();
+    }
+    if (directions.size() != num_edges)
+        return;
+    const float values[3] = { min_height_testing, max_height_testing,
+                              m_lap_length };
+
+    std::string tmp = StringUtils::insertValues("%s.%d.tmp", filename.c_str(),
+        (int)StkTime::getMonoTimeMs());
+    FILE* f = FileUtils::fopenU8Path(tmp, "wb");
+    if (!f)
+        return;
+    bool success =
+        fwrite(DRIVELINE_HEADER, sizeof(DRIVELINE_HEADER), 1, f) == 1 &&
+        fwrite(&DRIVELINE_BYTE_ORDER, sizeof(DRIVELINE_BYTE_ORDER), 1, f)
+            == 1 &&
+        fwrite(&n, sizeof(n), 1, f) == 1 &&
+        fwrite(&num_edges, sizeof(num_edges), 1, f) == 1 &&
+        fwrite(values, sizeof(values), 1, f) == 1 &&
+        writeVector(f, points) && writeVector(f, flags) &&
+        writeVector(f, distances) && writeVector(f, edges) &&
+        writeVector(f, directions) && writeVector(f, last_index) &&
+        writeVector(f, paths);
+    success &= fclose(f) == 0;
+    if (!success || FileUtils::renameU8Path(tmp, filename) != 0)
+    {
+        file_manager->removeFile(tmp);
+        return;
+    }
+    Log::info("DriveGraph", "Saved drive graph to '%s'.", filename.c_str());
+    file_manager->removeOutdatedCachedData(filename);
+}   // saveCache
+
+// ----------------------------------------------------------------------------
+/** Checks that a drive graph saved with saveCache is loaded unchanged by
+ *  loadCache, and that a cache file with an invalid path is rejected and
+ *  the graph is rebuilt instead. The test uses a loop of 40 quads with a
+ *  shortcut of 10 quads, so that some nodes have more than one successor.
+ *  Only one graph can exist at a time, so each graph is created and
+ *  destroyed like the graph of a track, and compared using a text
+ *  description of all its data.
+ */
+void DriveGraph::unitTesting()
+{
+    const std::string dir = file_manager->getCachedDataDir();
+    const std::string quad_file = dir + "unit-test-quads.xml";
+    const std::string graph_file = dir + "unit-test-graph.xml";
+    FILE* f = FileUtils::fopenU8Path(quad_file, "wb");
+    if (!f)
+    {
+        Log::error("DriveGraph", "Can't write '%s'.", quad_file.c_str());
+        return;
+    }
+    fprintf(f, "<quads>\n");
+    for (int i = 0; i < 40; i++)
+    {
+        const float a0 = i * 2.0f * M_PI / 40, a1 = (i + 1) * 2.0f * M_PI / 40;
+        fprintf(f, "  <quad p0=\"%f 0 %f\" p1=\"%f 0 %f\" p2=\"%f 0 %f\" "
+                   "p3=\"%f 0 %f\"/>\n",
+                45.0f * cosf(a0), 45.0f * sinf(a0),
+                55.0f * cosf(a0), 55.0f * sinf(a0),
+                55.0f * cosf(a1), 55.0f * sinf(a1),
+                45.0f * cosf(a1), 45.0f * sinf(a1));
+    }
+    // The shortcut goes straight from the end of quad 5 to quad 25
+    const float a0 = 6 * 2.0f * M_PI / 40, a1 = 25 * 2.0f * M_PI / 40;
+    const Vec3 start(50.0f * cosf(a0), 0, 50.0f * sinf(a0));
+    const Vec3 end(50.0f * cosf(a1), 0, 50.0f * sinf(a1));
+    const Vec3 side = (end - start).cross(Vec3(0, 1, 0)).normalized() * 3.0f;
+    for (int i = 0; i < 10; i++)
+    {
+        const Vec3 c0 = start + (end - start) * (i / 10.0f);
+        const Vec3 c1 = start + (end - start) * ((i + 1) / 10.0f);
+        fprintf(f, "  <quad p0=\"%f 0 %f\" p1=\"%f 0 %f\" p2=\"%f 0 %f\" "
+                   "p3=\"%f 0 %f\"/>\n",
+                (c0 - side).getX(), (c0 - side).getZ(),
+                (c0 + side).getX(), (c0 + side).getZ(),
+                (c1 + side).getX(), (c1 + side).getZ(),
+                (c1 - side).getX(), (c1 - side).getZ());
+    }
+    fprintf(f, "</quads>\n");
+    fclose(f);
+    f = FileUtils::fopenU8Path(graph_file, "wb");
+    if (!f)
+    {
+        Log::error("DriveGraph", "Can't write '%s'.", graph_file.c_str());
+        file_manager->removeFile(quad_file);
+        return;
+    }
+    fprintf(f, "<graph>\n"
+               "  <node-list from-quad=\"0\" to-quad=\"49\"/>\n"
+               "  <edge-loop from=\"0\" to=\"39\"/>\n"
+               "  <edge from=\"5\" to=\"40\"/>\n"
+               "  <edge-line from=\"40\" to=\"49\"/>\n"
+               "  <edge from=\"49\" to=\"25\"/>\n"
+               "</graph>\n");
+    fclose(f);
+
+    // Returns all data of the current graph except the lap length
+    auto describe = []() -> std::string
+    {
+        const DriveGraph* dg = DriveGraph::get();
+        std::ostringstream s;
+        s.precision(9);
+        for (unsigned int i = 0; i < dg->getNumNodes(); i++)
+        {
+            const DriveNode* dn = dg->getNode(i);
+            s << "node " << i << ":";
+            for (unsigned int j = 0; j < 4; j++)
+            {
+                s << " " << (*dn)[j].getX() << " " << (*dn)[j].getY()
+                  << " " << (*dn)[j].getZ();
+            }
+            s << " flags " << dn->isInvisible() << dn->letAIIgnore()
+              << dn->isIgnored() << " distance "
+              << dn->getDistanceFromStart() << " successors";
+            for (unsigned int j = 0; j < dn->getNumberOfSuccessors(); j++)
+            {
+                DriveNode::DirectionType dir;
+                unsigned int last;
+                dn->getDirectionData(j, &dir, &last);
+                s << " " << dn->getSuccessor(j) << "/" << dir << "/" << last;
+            }
+            s << " predecessors";
+            for (unsigned int j = 0; j < dn->getNumberOfPredecessors(); j++)
+                s << " " << dn->getPredecessor(j);
+            s << " paths";
+            for (int path : dn->getPathsToNode())
+                s << " " << path;
+            s << "\n";
+        }
+        return s.str();
+    };   // describe
+
+    // Compute the graph without a cache file, which saves the cache file
+    new DriveGraph(quad_file, graph_file, false);
+    const std::string cache_file = get()->getCacheFile(quad_file,
+                                                       graph_file);
+    file_manager->removeFile(cache_file);
+    Graph::destroy();
+    new DriveGraph(quad_file, graph_file, false);
+    const std::string computed = describe();
+    const float lap_length = get()->getLapLength();
+    const unsigned int num_nodes = get()->getNumNodes();
+    const bool has_shortcut =
+        num_nodes == 50 && get()->getNode(5)->getNumberOfSuccessors() == 2;
+    Graph::destroy();
+
+    if (cache_file.empty() || !file_manager->fileExists(cache_file))
+        Log::error("DriveGraph", "Drive graph cache file was not saved.");
+    else if (!has_shortcut)
+        Log::error("DriveGraph", "Wrong test drive graph.");
+    else
+    {
+        // Change the lap length in the cache file, so it is known that the
+        // next graph is loaded from the cache file
+        const float cached_lap_length = lap_length + 1.0f;
+        f = FileUtils::fopenU8Path(cache_file, "r+b");
+        if (f)
+        {
+            fseek(f, sizeof(DRIVELINE_HEADER) + 3 * sizeof(uint32_t) +
+                     2 * sizeof(float), SEEK_SET);
+            fwrite(&cached_lap_length, sizeof(cached_lap_length), 1, f);
+            fclose(f);
+        }
+        new DriveGraph(quad_file, graph_file, false);
+        if (get()->getLapLength() != cached_lap_length)
+            Log::error("DriveGraph", "Drive graph was not loaded from cache.");
+        else if (describe() != computed)
+            Log::error("DriveGraph", "Cached drive graph is different.");
+        Graph::destroy();
+
+        // Store a successor index which doesn't exist in the paths of the
+        // shortcut node 5. Its paths are the last data in the file, since it
+        // is the only node with more than one successor. This cache file
+        // must not be used, the graph is rebuilt instead.
+        const int32_t invalid_path = 2;
+        f = FileUtils::fopenU8Path(cache_file, "r+b");
+        if (f)
+        {
+            fseek(f, -(long)((num_nodes - 30) * sizeof(int32_t)), SEEK_END);
+            fwrite(&invalid_path, sizeof(invalid_path), 1, f);
+            fclose(f);
+        }
+        new DriveGraph(quad_file, graph_file, false);
+        if (get()->getLapLength() != lap_length || describe() != computed)
+            Log::error("DriveGraph", "Invalid cache file was used.");
+        Graph::destroy();
+    }
+
+    file_manager->removeFile(cache_file);
+    file_manager->removeFile(quad_file);
+    file_manager->removeFile(graph_file);
+}   // unitTesting
+
 // ----------------------------------------------------------------------------
 /** Returns the index of the first graph node (i.e. the graph node which
  *  will trigger a new lap when a kart first enters it). This is always
@@ -723,15 +1225,6 @@ void DriveGraph::differentNodeColor(int n, video::SColor* c) const
 
 }   // differentNodeColor
 
-// -----------------------------------------------------------------------------
-DriveNode* DriveGraph::getNode(unsigned int j) const
-{
-    assert(j < m_all_nodes.size());
-    DriveNode* n = dynamic_cast<DriveNode*>(m_all_nodes[j]);
-    assert(n != NULL);
-    return n;
-}   // getNode
-
 // -----------------------------------------------------------------------------
 bool DriveGraph::hasLapLine() const
 {
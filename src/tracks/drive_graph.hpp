@@ -47,6 +47,13 @@ private:
     /** Wether the graph should be reverted or not */
     bool m_reverse;
 
+    /** The same nodes as m_all_nodes, to access them without a cast. */
+    std::vector<DriveNode*> m_drive_nodes;
+
+    /** All edges (pairs of node and successor) in the order in which they
+     *  were added, only used while loading to save the cache. */
+    std::vector<int> m_edges;
+
     // ------------------------------------------------------------------------
     void setDefaultSuccessors();
     // ------------------------------------------------------------------------
@@ -62,6 +69,15 @@ private:
     // ------------------------------------------------------------------------
     void load(const std::string &quad_file_name, const std::string &filename);
     // ------------------------------------------------------------------------
+    std::string getCacheFile(const std::string &quad_file_name,
+                             const std::string &graph_file_name) const;
+    // ------------------------------------------------------------------------
+    bool loadCache(const std::string &filename);
+    // ------------------------------------------------------------------------
+    void saveCache(const std::string &filename) const;
+    // ------------------------------------------------------------------------
+    void setupPaths();
+    // ------------------------------------------------------------------------
     void getPoint(const XMLNode *xml, const std::string &attribute_name,
                   Vec3 *result) const;
     // ------------------------------------------------------------------------
@@ -74,13 +90,19 @@ private:
     virtual void differentNodeColor(int n, video::SColor* c) const OVERRIDE;
 
 public:
-    static DriveGraph* get()     { return dynamic_cast<DriveGraph*>(m_graph); }
+    static DriveGraph* get()
+    {
+        return m_graph && !m_graph->isArena() ?
+            static_cast<DriveGraph*>(m_graph) : NULL;
+    }   // get
     // ------------------------------------------------------------------------
     DriveGraph(const std::string &quad_file_name,
                const std::string &graph_file_name, const bool reverse);
     // ------------------------------------------------------------------------
     virtual ~DriveGraph() {}
     // ------------------------------------------------------------------------
+    static void unitTesting();
+    // ------------------------------------------------------------------------
     void getSuccessors(int node_number, std::vector<unsigned int>& succ,
                        bool for_ai=false) const;
     // ------------------------------------------------------------------------
@@ -95,8 +117,6 @@ public:
     void updateDistancesForAllSuccessors(unsigned int indx, float delta,
                                          unsigned int count);
     // ------------------------------------------------------------------------
-    void setupPaths();
-    // ------------------------------------------------------------------------
     void computeChecklineRequirements();
     // ------------------------------------------------------------------------
     /** Return the distance to the j-th successor of node n. */
@@ -110,7 +130,11 @@ public:
     int getNumberOfSuccessors(int n) const;
     // ------------------------------------------------------------------------
     /** Returns the quad that belongs to a graph node. */
-    DriveNode* getNode(unsigned int j) const;
+    DriveNode* getNode(unsigned int j) const
+    {
+        assert(j < m_drive_nodes.size());
+        return m_drive_nodes[j];
+    }
     // ------------------------------------------------------------------------
     /** Returns the distance from the start to the beginning of a quad. */
     float getDistanceFromStart(int j) const;
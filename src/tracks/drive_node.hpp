@@ -176,6 +176,15 @@ public:
         return m_path_to_node.size()>0 ? m_path_to_node[n] : 0;
     }   // getSuccesorToReach
     // ------------------------------------------------------------------------
+    /** Returns which successor to use to reach each drive node, empty if
+     *  this node has less than two successors. */
+    const std::vector<int>& getPathsToNode() const   { return m_path_to_node; }
+    // ------------------------------------------------------------------------
+    /** Sets the paths computed by setupPathsToNode, used when the drive
+     *  graph is loaded from the cache. */
+    void setPathsToNode(const std::vector<int>& paths)
+                                                    { m_path_to_node = paths; }
+    // ------------------------------------------------------------------------
     /** Returns the checkline requirements of this drive node. */
     const std::vector<int>& getChecklineRequirements() const
                                            { return m_checkline_requirements; }
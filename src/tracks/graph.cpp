@@ -32,13 +32,17 @@
 #include "tracks/drive_node_3d.hpp"
 #include "tracks/track.hpp"
 #include "utils/log.hpp"
+#include "utils/random_generator.hpp"
+#include "utils/time.hpp"
+
+#include <algorithm>
 
 const int Graph::UNKNOWN_SECTOR = -1;
 const float Graph::MIN_HEIGHT_TESTING = -1.0f;
 const float Graph::MAX_HEIGHT_TESTING = 5.0f;
 Graph *Graph::m_graph = NULL;
 // -----------------------------------------------------------------------------
-Graph::Graph()
+Graph::Graph(bool is_arena) : m_is_arena(is_arena)
 {
     m_scaling     = 0;
     m_node        = NULL;
@@ -48,6 +52,11 @@ Graph::Graph()
     m_bb_min      = Vec3( 99999,  99999,  99999);
     m_bb_max      = Vec3(-99999, -99999, -99999);
     memset(m_bb_nodes, 0, 4 * sizeof(int));
+    m_grid_min_x  = 0;
+    m_grid_min_z  = 0;
+    m_grid_cell_size = 1.0f;
+    m_grid_width  = 0;
+    m_grid_height = 0;
 }  // Graph
 
 // -----------------------------------------------------------------------------
@@ -536,10 +545,10 @@ void Graph::mapPoint2MiniMap(const Vec3 &xyz,Vec3 *draw_at) const
 }   // mapPoint
 
 // -----------------------------------------------------------------------------
-void Graph::createQuad(const Vec3 &p0, const Vec3 &p1, const Vec3 &p2,
-                       const Vec3 &p3, unsigned int node_index,
-                       bool invisible, bool ai_ignore, bool is_arena,
-                       bool ignored)
+Quad* Graph::createQuad(const Vec3 &p0, const Vec3 &p1, const Vec3 &p2,
+                        const Vec3 &p3, unsigned int node_index,
+                        bool invisible, bool ai_ignore, bool is_arena,
+                        bool ignored)
 {
     // Find the normal of this quad by computing the normal of two triangles
     // and taking their average.
@@ -590,7 +599,7 @@ void Graph::createQuad(const Vec3 &p0, const Vec3 &p1, const Vec3 &p2,
 
     m_bb_max.max(p0); m_bb_max.max(p1); m_bb_max.max(p2); m_bb_max.max(p3);
     m_bb_min.min(p0); m_bb_min.min(p1); m_bb_min.min(p2); m_bb_min.min(p3);
-
+    return q;
 }   // createQuad
 
 //-----------------------------------------------------------------------------
@@ -634,6 +643,24 @@ void Graph::findRoadSector(const Vec3& xyz, int *sector,
                             ? (unsigned int)all_sectors->size()
                             : (unsigned int)m_all_nodes.size();
     *sector = UNKNOWN_SECTOR;
+    if (!all_sectors && useSectorGrid())
+    {
+        // The next quad is the one a kart usually moves to, and it is the
+        // first one tested by the linear search below, so test it before
+        // the other quads.
+        int start = indx < (int)m_all_nodes.size()-1 ? indx + 1 : 0;
+        if (indx != UNKNOWN_SECTOR &&
+            getQuad(start)->pointInside(xyz, ignore_vertical))
+        {
+            *sector = start;
+            return;
+        }
+        // Only the quads in the grid cell of xyz (and the few unbounded
+        // ones) can contain xyz. The grid picks the same quad as the linear
+        // search below if quads overlap.
+        *sector = findRoadSectorInGrid(xyz, start, ignore_vertical);
+        return;
+    }
     for(unsigned int i=0; i<max_count; i++)
     {
         if(all_sectors)
@@ -707,6 +734,21 @@ int Graph::findOutOfRoadSector(const Vec3& xyz, const int curr_sector,
         if(current_sector<0) current_sector += getNumNodes();
     }
 
+    if (!all_sectors && useSectorGrid())
+    {
+        const int n = getNumNodes();
+        int start = ((current_sector + 1) % n + n) % n;
+        for (int phase = 0; phase < 2; phase++)
+        {
+            int sector = findOutOfRoadSectorInGrid(xyz, start, phase,
+                                                   ignore_vertical);
+            if (sector != UNKNOWN_SECTOR)
+                return sector;
+        }
+        Log::warn("Graph", "unknown sector found.");
+        return 0;
+    }
+
     int   min_sector = UNKNOWN_SECTOR;
     float min_dist_2 = 999999.0f*999999.0f;
 
@@ -774,3 +816,301 @@ void Graph::loadBoundingBoxNodes()
     m_bb_nodes[3] = findOutOfRoadSector(Vec3(m_bb_max.x(), 0, m_bb_max.z()),
         -1/*curr_sector*/, NULL/*all_sectors*/, true/*ignore_vertical*/);
 }   // loadBoundingBoxNodes
+
+//-----------------------------------------------------------------------------
+/** Builds the uniform grid used by findRoadSector and findOutOfRoadSector.
+ *  Must be called once all quads are created.
+ */
+void Graph::buildSectorGrid()
+{
+    m_grid_cell_start.clear();
+    m_grid_quads.clear();
+    m_grid_unbounded_quads.clear();
+    const unsigned int n = getNumNodes();
+    if (n == 0)
+        return;
+
+    // The (xz) bounding rectangle of each quad. 3d quads test points inside
+    // a box extruded along the normal (see BoundingBox3D), so the extent of
+    // that box is used for them. A small margin is added to be safe.
+    const float margin = 0.1f;
+    std::vector<core::rectf> rects(n);
+    float min_x =  99999.0f, min_z =  99999.0f;
+    float max_x = -99999.0f, max_z = -99999.0f;
+    float total_size = 0.0f;
+    for (unsigned int i = 0; i < n; i++)
+    {
+        const Quad* q = m_all_nodes[i];
+        core::rectf& r = rects[i];
+        r = core::rectf((*q)[0].getX(), (*q)[0].getZ(),
+                        (*q)[0].getX(), (*q)[0].getZ());
+        for (int j = 0; j < 4; j++)
+            r.addInternalPoint((*q)[j].getX(), (*q)[j].getZ());
+        if (q->is3DQuad())
+        {
+            // 3d quads are always ArenaNode3D or DriveNode3D
+            const BoundingBox3D* box;
+            if (isArena())
+                box = static_cast<const ArenaNode3D*>(q);
+            else
+                box = static_cast<const DriveNode3D*>(q);
+            Vec3 box_min, box_max;
+            if (box->getExtent(&box_min, &box_max))
+            {
+                r.addInternalPoint(box_min.getX(), box_min.getZ());
+                r.addInternalPoint(box_max.getX(), box_max.getZ());
+            }
+            else
+            {
+                // Keep the quad in the cells around its corners, which are
+                // still used by findOutOfRoadSectorInGrid
+                m_grid_unbounded_quads.push_back(i);
+            }
+        }
+        r.UpperLeftCorner  -= core::vector2df(margin, margin);
+        r.LowerRightCorner += core::vector2df(margin, margin);
+        min_x = std::min(min_x, r.UpperLeftCorner.X);
+        min_z = std::min(min_z, r.UpperLeftCorner.Y);
+        max_x = std::max(max_x, r.LowerRightCorner.X);
+        max_z = std::max(max_z, r.LowerRightCorner.Y);
+        total_size += std::max(r.getWidth(), r.getHeight());
+    }
+
+    // Use the average quad size as cell size, so each quad only overlaps
+    // a few cells. Limit the number of cells for graphs with a few small
+    // quads far apart.
+    m_grid_cell_size = std::max(total_size / n, 1.0f);
+    while ((max_x - min_x) * (max_z - min_z) /
+           (m_grid_cell_size * m_grid_cell_size) > 16.0f * n + 256.0f)
+        m_grid_cell_size *= 2.0f;
+    m_grid_min_x  = min_x;
+    m_grid_min_z  = min_z;
+    m_grid_width  = (int)((max_x - min_x) / m_grid_cell_size) + 1;
+    m_grid_height = (int)((max_z - min_z) / m_grid_cell_size) + 1;
+
+    // Count the quads in each cell first, then fill them in.
+    const int num_cells = m_grid_width * m_grid_height;
+    m_grid_cell_start.resize(num_cells + 1, 0);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        std::vector<unsigned int> next;
+        if (pass == 1)
+        {
+            for (int i = 0; i < num_cells; i++)
+                m_grid_cell_start[i + 1] += m_grid_cell_start[i];
+            m_grid_quads.resize(m_grid_cell_start[num_cells]);
+            next.assign(m_grid_cell_start.begin(),
+                        m_grid_cell_start.end() - 1);
+        }
+        for (unsigned int i = 0; i < n; i++)
+        {
+            int x0, z0, x1, z1;
+            getGridCell(Vec3(rects[i].UpperLeftCorner.X, 0,
+                             rects[i].UpperLeftCorner.Y), &x0, &z0);
+            getGridCell(Vec3(rects[i].LowerRightCorner.X, 0,
+                             rects[i].LowerRightCorner.Y), &x1, &z1);
+            for (int z = z0; z <= z1; z++)
+            {
+                for (int x = x0; x <= x1; x++)
+                {
+                    const int cell = z * m_grid_width + x;
+                    if (pass == 0)
+                        m_grid_cell_start[cell + 1]++;
+                    else
+                        m_grid_quads[next[cell]++] = i;
+                }
+            }
+        }
+    }
+    Log::debug("Graph", "Sector grid with %dx%d cells of size %f, %d entries, "
+               "%d unbounded quads.", m_grid_width, m_grid_height,
+               m_grid_cell_size, (int)m_grid_quads.size(),
+               (int)m_grid_unbounded_quads.size());
+}   // buildSectorGrid
+
+//-----------------------------------------------------------------------------
+/** Returns the grid cell containing xyz. Points outside of the grid are
+ *  mapped to the closest cell.
+ */
+void Graph::getGridCell(const Vec3& xyz, int* x, int* z) const
+{
+    *x = (int)floorf((xyz.getX() - m_grid_min_x) / m_grid_cell_size);
+    *z = (int)floorf((xyz.getZ() - m_grid_min_z) / m_grid_cell_size);
+    *x = std::min(std::max(*x, 0), m_grid_width  - 1);
+    *z = std::min(std::max(*z, 0), m_grid_height - 1);
+}   // getGridCell
+
+//-----------------------------------------------------------------------------
+/** Returns the quad containing xyz using the sector grid. If xyz is inside
+ *  of several quads, the first one found by the linear search in
+ *  findRoadSector (which starts at start) is returned.
+ */
+int Graph::findRoadSectorInGrid(const Vec3& xyz, int start,
+                                bool ignore_vertical) const
+{
+    const int n = getNumNodes();
+    int sector = UNKNOWN_SECTOR;
+    int min_offset = n;
+    for (int indx : m_grid_unbounded_quads)
+    {
+        const int offset = (indx - start + n) % n;
+        if (offset < min_offset &&
+            m_all_nodes[indx]->pointInside(xyz, ignore_vertical))
+        {
+            sector = indx;
+            min_offset = offset;
+        }
+    }
+
+    const float x = (xyz.getX() - m_grid_min_x) / m_grid_cell_size;
+    const float z = (xyz.getZ() - m_grid_min_z) / m_grid_cell_size;
+    if (x < 0 || z < 0 || x >= m_grid_width || z >= m_grid_height)
+        return sector;
+
+    const int cell = (int)z * m_grid_width + (int)x;
+    for (unsigned int i = m_grid_cell_start[cell];
+         i < m_grid_cell_start[cell + 1]; i++)
+    {
+        const int indx = m_grid_quads[i];
+        const int offset = (indx - start + n) % n;
+        if (offset < min_offset &&
+            m_all_nodes[indx]->pointInside(xyz, ignore_vertical))
+        {
+            sector = indx;
+            min_offset = offset;
+        }
+    }
+    return sector;
+}   // findRoadSectorInGrid
+
+//-----------------------------------------------------------------------------
+/** Finds the closest quad like one phase of findOutOfRoadSector, but only
+ *  tests the quads in the grid cells around xyz. Cells are searched in
+ *  growing rings, till the ring is further away than the closest quad found.
+ *  This relies on the distance of a node being at least the 2d distance
+ *  to its bounding rectangle.
+ */
+int Graph::findOutOfRoadSectorInGrid(const Vec3& xyz, int start, int phase,
+                                     bool ignore_vertical) const
+{
+    const int n = getNumNodes();
+    int cx, cz;
+    getGridCell(xyz, &cx, &cz);
+    const int max_ring = std::max(m_grid_width, m_grid_height);
+
+    int   min_sector = UNKNOWN_SECTOR;
+    int   min_offset = n;
+    float min_dist_2 = 999999.0f*999999.0f;
+    for (int ring = 0; ring <= max_ring; ring++)
+    {
+        // All cells of this ring are at least (ring-1) cells away from the
+        // (closest point in the grid to) xyz.
+        if (min_sector != UNKNOWN_SECTOR && ring > 1)
+        {
+            const float d = (ring - 1) * m_grid_cell_size;
+            if (d * d > min_dist_2)
+                break;
+        }
+        for (int z = cz - ring; z <= cz + ring; z++)
+        {
+            if (z < 0 || z >= m_grid_height)
+                continue;
+            const bool edge = z == cz - ring || z == cz + ring;
+            for (int x = cx - ring; x <= cx + ring;
+                 x += edge || ring == 0 ? 1 : 2 * ring)
+            {
+                if (x < 0 || x >= m_grid_width)
+                    continue;
+                const int cell = z * m_grid_width + x;
+                for (unsigned int i = m_grid_cell_start[cell];
+                     i < m_grid_cell_start[cell + 1]; i++)
+                {
+                    const int indx = m_grid_quads[i];
+                    const Quad* q = m_all_nodes[indx];
+                    if (q->isIgnored())
+                        continue;
+                    const float dist_2 = q->getDistance2FromPoint(xyz);
+                    const int offset = (indx - start + n) % n;
+                    if (dist_2 > min_dist_2 ||
+                        (dist_2 == min_dist_2 && offset >= min_offset))
+                        continue;
+                    // Same height test as in findOutOfRoadSector
+                    float dist = xyz.getY() - q->getMinHeight();
+                    if (phase == 1 || (dist < 5.0f && dist>-1.0f) ||
+                        q->is3DQuad() || ignore_vertical)
+                    {
+                        min_dist_2 = dist_2;
+                        min_sector = indx;
+                        min_offset = offset;
+                    }
+                }   // for i in cell
+            }   // for x
+        }   // for z
+    }   // for ring
+    return min_sector;
+}   // findOutOfRoadSectorInGrid
+
+//-----------------------------------------------------------------------------
+/** Compares the results and time of the grid and linear searches for random
+ *  points around the graph, used in unit testing. Logs an error for each
+ *  point for which both searches find a different sector.
+ *  \param num_points Number of points to test.
+ */
+void Graph::testSectorGrid(unsigned int num_points)
+{
+    if (!useSectorGrid())
+        buildSectorGrid();
+    std::vector<Vec3> points;
+    std::vector<int> sectors;
+    RandomGenerator random;
+    for (unsigned int i = 0; i < num_points; i++)
+    {
+        // Use points around a random quad, so most points are on or close to
+        // the graph, with the previous sector being the one of the last point
+        const Quad* q = m_all_nodes[random.get(getNumNodes())];
+        Vec3 p = q->getCenter() + Vec3(random.get(2000) * 0.01f - 10.0f,
+                                       random.get(400) * 0.01f - 1.0f,
+                                       random.get(2000) * 0.01f - 10.0f);
+        points.push_back(p);
+    }
+
+    int error_count = 0;
+    std::vector<unsigned int> cell_start;
+    for (int grid = 1; grid >= 0; grid--)
+    {
+        if (grid == 0)
+            std::swap(cell_start, m_grid_cell_start);
+        std::vector<int> result;
+        double start = StkTime::getRealTime();
+        int sector = UNKNOWN_SECTOR;
+        for (const Vec3& p : points)
+        {
+            int prev = sector;
+            findRoadSector(p, &sector);
+            if (sector == UNKNOWN_SECTOR)
+                sector = findOutOfRoadSector(p, prev);
+            result.push_back(sector);
+        }
+        double end = StkTime::getRealTime();
+        Log::info("Graph", "%s search: %lf s for %d points.",
+                  grid ? "Grid" : "Linear", end - start, num_points);
+        if (grid)
+        {
+            sectors = result;
+            continue;
+        }
+        std::swap(cell_start, m_grid_cell_start);
+        for (unsigned int i = 0; i < num_points; i++)
+        {
+            if (result[i] != sectors[i])
+            {
+                Log::error("Graph", "Point %f %f %f: grid %d, linear %d.",
+                           points[i].getX(), points[i].getY(),
+                           points[i].getZ(), sectors[i], result[i]);
+                error_count++;
+            }
+        }
+    }
+    if (error_count > 0)
+        Log::error("Graph", "Sector grid: %d errors.", error_count);
+}   // testSectorGrid
@@ -58,16 +58,23 @@ protected:
 
     // ------------------------------------------------------------------------
     /** Factory method to dynamic create 2d / 3d quad for drive and arena
-     *  graph. */
-    void createQuad(const Vec3 &p0, const Vec3 &p1, const Vec3 &p2,
+     *  graph, returns the created quad. */
+    Quad* createQuad(const Vec3 &p0, const Vec3 &p1, const Vec3 &p2,
                     const Vec3 &p3, unsigned int node_index,
                     bool invisible, bool ai_ignore, bool is_arena,
                     bool ignore);
     // ------------------------------------------------------------------------
     /** Map 4 bounding box points to 4 closest graph nodes. */
     void loadBoundingBoxNodes();
+    // ------------------------------------------------------------------------
+    void buildSectorGrid();
+    // ------------------------------------------------------------------------
+    void testSectorGrid(unsigned int num_points);
 
 private:
+    /** If this is an arena graph (otherwise it's a drive graph). */
+    const bool m_is_arena;
+
     /** The 2d bounding box, used for hashing. */
     Vec3 m_bb_min;
     Vec3 m_bb_max;
@@ -75,6 +82,19 @@ private:
     /** The 4 closest graph nodes to the bounding box. */
     int m_bb_nodes[4];
 
+    /** A uniform 2d grid on the xz plane to find the quads near a point
+     *  without testing all quads. Each cell stores all quads whose (xz)
+     *  bounding rectangle overlaps the cell, the quads of cell i are
+     *  m_grid_quads[m_grid_cell_start[i]] till (excluding)
+     *  m_grid_quads[m_grid_cell_start[i+1]]. Empty if not built. */
+    std::vector<unsigned int> m_grid_cell_start;
+    std::vector<int> m_grid_quads;
+    /** 3d quads whose pointInside test can accept points anywhere (see
+     *  BoundingBox3D::getExtent), which are tested for every point. */
+    std::vector<int> m_grid_unbounded_quads;
+    float m_grid_min_x, m_grid_min_z, m_grid_cell_size;
+    int m_grid_width, m_grid_height;
+
     /** The node of the graph mesh. */
     scene::ISceneNode *m_node;
 
@@ -106,6 +126,17 @@ private:
     virtual bool hasLapLine() const = 0;
     // ------------------------------------------------------------------------
     virtual void differentNodeColor(int n, video::SColor* c) const = 0;
+    // ------------------------------------------------------------------------
+    void getGridCell(const Vec3& xyz, int* x, int* z) const;
+    // ------------------------------------------------------------------------
+    int findRoadSectorInGrid(const Vec3& xyz, int start,
+                             bool ignore_vertical) const;
+    // ------------------------------------------------------------------------
+    int findOutOfRoadSectorInGrid(const Vec3& xyz, int start, int phase,
+                                  bool ignore_vertical) const;
+    // ------------------------------------------------------------------------
+    /** Returns true if the sector grid can be used. */
+    bool useSectorGrid() const          { return !m_grid_cell_start.empty(); }
 
 public:
     static const int UNKNOWN_SECTOR;
@@ -137,10 +168,14 @@ public:
         }
     }   // destroy
     // ------------------------------------------------------------------------
-    Graph();
+    Graph(bool is_arena);
     // ------------------------------------------------------------------------
     virtual ~Graph();
     // ------------------------------------------------------------------------
+    /** Returns if this is an arena graph, used by ArenaGraph::get() and
+     *  DriveGraph::get() to avoid a dynamic_cast. */
+    bool isArena() const                                 { return m_is_arena; }
+    // ------------------------------------------------------------------------
     void createDebugMesh();
     // ------------------------------------------------------------------------
     RenderTarget* makeMiniMap(const core::dimension2du &dimension,
@@ -93,6 +93,10 @@ public:
         m_max_height_testing = max;
     }
     // ------------------------------------------------------------------------
+    float getMinHeightTesting() const          { return m_min_height_testing; }
+    // ------------------------------------------------------------------------
+    float getMaxHeightTesting() const          { return m_max_height_testing; }
+    // ------------------------------------------------------------------------
     /** Returns the minimum height of a quad. */
     float getMinHeight() const                         { return m_min_height; }
     // ------------------------------------------------------------------------
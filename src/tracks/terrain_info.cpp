@@ -33,6 +33,7 @@ TerrainInfo::TerrainInfo()
 {
     m_last_material = NULL;
     m_material      = NULL;
+    m_flags         = 0;
 }   // TerrainInfo
 
 //-----------------------------------------------------------------------------
@@ -44,6 +45,7 @@ TerrainInfo::TerrainInfo(const Vec3 &pos)
     // initialise HoT
     m_last_material = NULL;
     m_material = NULL;
+    m_flags = 0;
     update(pos);
 }   // TerrainInfo
 
@@ -59,11 +61,11 @@ void TerrainInfo::update(const Vec3 &from)
 
     const TriangleMesh &tm = Track::getCurrentTrack()->getTriangleMesh();
     tm.castRay(from, to, &m_hit_point, &m_material, &m_normal,
-               /*interpolate*/false);
+               /*interpolate*/false, &m_flags);
     // Now also raycast against all track objects (that are driveable).
     Track::getCurrentTrack()->getTrackObjectManager()
                      ->castRay(from, to, &m_hit_point, &m_material,
-                               &m_normal, /*interpolate*/false);
+                               &m_normal, /*interpolate*/false, &m_flags);
 }   // update
 
 //-----------------------------------------------------------------------------
@@ -84,13 +86,14 @@ void TerrainInfo::update(const btMatrix3x3 &rotation, const Vec3 &from)
 
     const TriangleMesh &tm = Track::getCurrentTrack()->getTriangleMesh();
     tm.castRay(from, to, &m_hit_point, &m_material, &m_normal,
-               /*interpolate*/true);
+               /*interpolate*/true, &m_flags);
     // Now also raycast against all track objects (that are driveable). If
     // there should be a closer result (than the one against the main track 
     // mesh), its data will be returned.
     Track::getCurrentTrack()->getTrackObjectManager()
                             ->castRay(from, to, &m_hit_point, &m_material,
-                                      &m_normal, /*interpolate*/true);
+                                      &m_normal, /*interpolate*/true,
+                                      &m_flags);
 }   // update
 //-----------------------------------------------------------------------------
 /** Update the terrain information based on the latest position.
@@ -103,7 +106,8 @@ void TerrainInfo::update(const Vec3 &from, const Vec3 &towards)
     btVector3 to = from + 10000.0f*direction;
 
     const TriangleMesh &tm = Track::getCurrentTrack()->getTriangleMesh();
-    tm.castRay(from, to, &m_hit_point, &m_material, &m_normal);
+    tm.castRay(from, to, &m_hit_point, &m_material, &m_normal,
+               /*interpolate*/false, &m_flags);
 }   // update
 
 // -----------------------------------------------------------------------------
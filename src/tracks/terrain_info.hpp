@@ -19,6 +19,7 @@
 #ifndef HEADER_TERRAIN_INFO_HPP
 #define HEADER_TERRAIN_INFO_HPP
 
+#include "utils/types.hpp"
 #include "utils/vec3.hpp"
 
 class btTransform;
@@ -37,6 +38,10 @@ private:
     const Material   *m_material;
     /** The previous material a kart was on. */
     const Material   *m_last_material;
+    /** The terrain flags of m_material (see Material::TerrainFlags), which
+     *  are stored per triangle, so testing them doesn't need to read the
+     *  material. */
+    uint16_t          m_flags;
     /** The point that was hit. */
     Vec3              m_hit_point;
 
@@ -71,6 +76,10 @@ public:
      *  the same as getMaterial() ). */
     const Material *getLastMaterial()    const {return m_last_material;}
     // ------------------------------------------------------------------------
+    /** Returns true if the current material has the given terrain flag
+     *  (see Material::TerrainFlags), false if there is no material. */
+    bool hasTerrainFlag(uint16_t flag)   const {return (m_flags & flag)!=0;}
+    // ------------------------------------------------------------------------
     /** Returns the normal of the terrain the kart is on. */
     const Vec3 &getNormal()              const {return m_normal;       }
     // ------------------------------------------------------------------------
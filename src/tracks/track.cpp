@@ -76,6 +76,7 @@
 #include "tracks/model_definition_loader.hpp"
 #include "tracks/track_manager.hpp"
 #include "tracks/track_object_manager.hpp"
+#include "tracks/track_residency_pool.hpp"
 #include "utils/constants.hpp"
 #include "utils/log.hpp"
 #include "utils/mini_glm.hpp"
@@ -385,6 +386,10 @@ void Track::cleanup()
     // than once are in m_all_cached_mesh more than once (which is easier
     // than storing the mesh only once, but then having to test for each
     // mesh if it is already contained in the list or not).
+    // On servers recently used tracks keep their own reference to the
+    // meshes, so they stay in the cache for the next race on this track.
+    if (TrackResidencyPool::get() && !m_cache_track)
+        TrackResidencyPool::get()->retain(this, m_all_cached_meshes);
     for (unsigned int i = 0; i < m_all_cached_meshes.size(); i++)
     {
         irr_driver->dropAllTextures(m_all_cached_meshes[i]);
@@ -522,6 +527,7 @@ void Track::loadTrackInfo()
     m_gravity               = 9.80665f;
     m_friction              = stk_config->m_default_track_friction;
     m_smooth_normals        = false;
+    m_broadphase            = "";
     m_godrays               = false;
     m_godrays_opacity       = 1.0f;
     m_godrays_color         = video::SColor(255, 255, 255, 255);
@@ -584,6 +590,7 @@ void Track::loadTrackInfo()
         m_enable_auto_rescue = false;
     root->get("auto-rescue",           &m_enable_auto_rescue);
     root->get("smooth-normals",        &m_smooth_normals);
+    root->get("broadphase",            &m_broadphase);
     // Reverse is meaningless in arena
     if(m_is_arena || m_is_soccer)
         m_reverse_available = false;
@@ -797,9 +804,8 @@ void Track::loadDriveGraph(unsigned int mode_id, const bool reverse)
     new DriveGraph(m_root+m_all_modes[mode_id].m_quad_name,
         m_root+m_all_modes[mode_id].m_graph_name, reverse);
 
-    // setGraph is done in DriveGraph constructor
+    // setGraph and setupPaths are done in DriveGraph constructor
     assert(DriveGraph::get());
-    DriveGraph::get()->setupPaths();
 #ifdef DEBUG
     for(unsigned int i=0; i<DriveGraph::get()->getNumNodes(); i++)
     {
@@ -910,7 +916,10 @@ void Track::createPhysicsModel(unsigned int main_track_count)
         uploadNodeVertexBuffer(m_all_nodes[i]);
     }
     main_loop->renderGUI(5580);
-    m_track_mesh->createPhysicalBody(m_friction);
+    // The bvh of the full track is expensive to build, so it is cached
+    m_track_mesh->createPhysicalBody(m_friction,
+        (btCollisionObject::CollisionFlags)0,
+        m_track_mesh->getBvhCacheFile(m_root).c_str());
     main_loop->renderGUI(5585);
     m_gfx_effect_mesh->createCollisionShape();
     main_loop->renderGUI(5590);
@@ -2921,10 +2930,12 @@ void Track::copyFromMainProcess()
             m_track_object_manager->insertObject(clone);
     }
 
+    // The triangles and bvh are not changed anymore, so they are shared
+    // with the main process, only the bodies are created again
     m_track_mesh = new TriangleMesh(/*can_be_transformed*/false);
     m_gfx_effect_mesh = new TriangleMesh(/*can_be_transformed*/false);
-    m_track_mesh->copyFrom(*main_track->m_track_mesh);
-    m_gfx_effect_mesh->copyFrom(*main_track->m_gfx_effect_mesh);
+    m_track_mesh->shareFrom(*main_track->m_track_mesh);
+    m_gfx_effect_mesh->shareFrom(*main_track->m_gfx_effect_mesh);
 
     // At the moment we only use network for child track
     auto nim = std::make_shared<NetworkItemManager>();
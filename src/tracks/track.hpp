@@ -337,6 +337,10 @@ private:
     /** True if this track supports using smoothed normals. */
     bool                m_smooth_normals;
 
+    /** Name of the bullet broadphase to use for this track, empty to use
+     *  the default from stk_config. */
+    std::string         m_broadphase;
+
     bool                m_is_addon;
 
     float               m_fog_max;
@@ -656,6 +660,10 @@ public:
     /** Returns true if the normals of this track can be smoothed. */
     bool smoothNormals() const { return m_smooth_normals; }
     // ------------------------------------------------------------------------
+    /** Returns the name of the broadphase to use for this track, or an empty
+     *  string if the default should be used. */
+    const std::string& getBroadphase() const { return m_broadphase; }
+    // ------------------------------------------------------------------------
     /** Returns the track object manager. */
     TrackObjectManager* getTrackObjectManager() const
     {
@@ -581,13 +581,15 @@ void TrackObject::resetAfterRewind()
  *         based on the three normals of the triangle and the location of the
  *         hit point (which is more compute intensive, but results in much
  *         smoother results).
+ *  \param flags If not NULL, the terrain flags of the triangle hit.
  *  \return True if a triangle was hit, false otherwise (and no output
  *          variable will be set.
  */
 bool TrackObject::castRay(const btVector3 &from, 
                           const btVector3 &to, btVector3 *hit_point,
                           const Material **material, btVector3 *normal,
-                          bool interpolate_normal) const
+                          bool interpolate_normal,
+                          uint16_t *flags) const
 {
     if(!m_physical_object)
     {
@@ -595,7 +597,7 @@ bool TrackObject::castRay(const btVector3 &from,
         return false;
     }
     return m_physical_object->castRay(from, to, hit_point, material, normal,
-                                      interpolate_normal);
+                                      interpolate_normal, flags);
 }   // castRay
 
 // ----------------------------------------------------------------------------
@@ -132,7 +132,7 @@ public:
     bool castRay(const btVector3 &from, 
                  const btVector3 &to, btVector3 *hit_point,
                  const Material **material, btVector3 *normal,
-                 bool interpolate_normal) const;
+                 bool interpolate_normal, uint16_t *flags=NULL) const;
 
     TrackObject* getParentLibrary()
     {
@@ -22,6 +22,7 @@
 #include "animations/three_d_animation.hpp"
 #include "config/stk_config.hpp"
 #include "graphics/lod_node.hpp"
+#include "graphics/material.hpp"
 #include "graphics/material_manager.hpp"
 #include "io/xml_node.hpp"
 #include "network/network_config.hpp"
@@ -55,6 +56,8 @@ void TrackObjectManager::add(const XMLNode &xml_node, scene::ISceneNode* parent,
         m_all_objects.push_back(obj);
         if(obj->isDriveable())
             m_driveable_objects.push_back(obj);
+        if (obj->getPhysicalObject())
+            m_simulated_objects.push_back(obj);
     }
     catch (std::exception& e)
     {
@@ -94,8 +97,14 @@ void TrackObjectManager::init()
             curr->isEnabled() && curr->getPhysicalObject() &&
             curr->getPhysicalObject()->isDynamic())
         {
-            curr->getPhysicalObject()->getBody()
-                ->setActivationState(DISABLE_DEACTIVATION);
+            // Other objects can sleep when they are not moving, bullet wakes
+            // them up if they are hit. The soccer ball is always moving in
+            // a game and is checked every frame, so it's kept active.
+            if (curr->isSoccerBall())
+            {
+                curr->getPhysicalObject()->getBody()
+                    ->setActivationState(DISABLE_DEACTIVATION);
+            }
             curr->getPhysicalObject()->addForRewind();
             moveable_objects++;
         }
@@ -195,6 +204,20 @@ void TrackObjectManager::update(float dt)
     }
 }   // update
 
+// ----------------------------------------------------------------------------
+/** Updates only the track objects which can affect the simulation, i.e. the
+ *  ones with a physical object (which might be moved by an animation). Used
+ *  when replaying ticks, where sounds, particles etc. are not needed.
+ *  \param dt Time step size.
+ */
+void TrackObjectManager::updateSimulation(float dt)
+{
+    for (TrackObject* curr : m_simulated_objects)
+    {
+        curr->update(dt);
+    }
+}   // updateSimulation
+
 // ----------------------------------------------------------------------------
 void TrackObjectManager::resetAfterRewind()
 {
@@ -221,6 +244,8 @@ void TrackObjectManager::resetAfterRewind()
  *         based on the three normals of the triangle and the location of the
  *         hit point (which is more compute intensive, but results in much
  *         smoother results).
+ *  \param flags If not NULL, updated with the terrain flags of the material
+ *         if a closer track object was hit.
  *  \return True if a triangle was hit, false otherwise (and no output
  *          variable will be set.
  
@@ -229,7 +254,8 @@ bool TrackObjectManager::castRay(const btVector3 &from,
                                  const btVector3 &to, btVector3 *hit_point,
                                  const Material **material,
                                  btVector3 *normal,
-                                 bool interpolate_normal) const
+                                 bool interpolate_normal,
+                                 uint16_t *flags) const
 {
     bool result = false;
     float distance = 9999.9f;
@@ -248,8 +274,9 @@ bool TrackObjectManager::castRay(const btVector3 &from,
         btVector3 new_hit_point;
         const Material *new_material;
         btVector3 new_normal;
+        uint16_t new_flags;
         if(curr->castRay(from, to, &new_hit_point, &new_material, &new_normal,
-                      interpolate_normal))
+                      interpolate_normal, &new_flags))
         {
             float new_distance = new_hit_point.distance(from);
             // If the new hit is closer than the current hit, save
@@ -260,6 +287,8 @@ bool TrackObjectManager::castRay(const btVector3 &from,
                 *hit_point = new_hit_point;
                 *normal    = new_normal;
                 distance   = new_distance;
+                if (flags)
+                    *flags = new_flags;
                 result = true;
             }   // if new_distance < distance
         }   // if hit
@@ -271,6 +300,8 @@ bool TrackObjectManager::castRay(const btVector3 &from,
 void TrackObjectManager::insertObject(TrackObject* object)
 {
     m_all_objects.push_back(object);
+    if (object->getPhysicalObject())
+        m_simulated_objects.push_back(object);
 }
 
 // ----------------------------------------------------------------------------
@@ -280,6 +311,7 @@ void TrackObjectManager::insertObject(TrackObject* object)
  */
 void TrackObjectManager::removeObject(TrackObject* obj)
 {
+    m_simulated_objects.remove(obj);
     m_all_objects.remove(obj);
     delete obj;
 }   // removeObject
@@ -51,6 +51,10 @@ protected:
     /** A second list which holds all objects that karts can drive on. */
     PtrVector<TrackObject, REF> m_driveable_objects;
 
+    /** A third list which holds all objects with a physical object, which
+     *  are the only ones updated in simulation-only ticks. */
+    PtrVector<TrackObject, REF> m_simulated_objects;
+
 public:
          TrackObjectManager();
         ~TrackObjectManager();
@@ -61,13 +65,15 @@ public:
              TrackObject* parent_library);
     void updateGraphics(float dt);
     void update(float dt);
+    void updateSimulation(float dt);
     void resetAfterRewind();
     void handleExplosion(const Vec3 &pos, const PhysicalObject *mp,
                          bool secondary_hits=true);
     bool castRay(const btVector3 &from,
                  const btVector3 &to, btVector3 *hit_point,
                  const Material **material, btVector3 *normal = NULL,
-                 bool interpolate_normal = false) const;
+                 bool interpolate_normal = false,
+                 uint16_t *flags = NULL) const;
 
     void insertObject(TrackObject* object);
 
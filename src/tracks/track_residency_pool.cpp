@@ -0,0 +1,245 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "tracks/track_residency_pool.hpp"
+
+#include "graphics/irr_driver.hpp"
+#include "guiengine/engine.hpp"
+#include "io/file_manager.hpp"
+#include "io/xml_node.hpp"
+#include "network/server_config.hpp"
+#include "tracks/track.hpp"
+#include "utils/log.hpp"
+#include "utils/string_utils.hpp"
+
+#include <IMeshCache.h>
+#include <ISceneManager.h>
+
+#include <algorithm>
+
+TrackResidencyPool* TrackResidencyPool::m_pool = NULL;
+
+// ----------------------------------------------------------------------------
+/** Creates the pool if it's enabled in server config and no graphics are
+ *  used. */
+void TrackResidencyPool::create()
+{
+    if (m_pool || !GUIEngine::isNoGraphics() ||
+        ServerConfig::m_track_residency_pool_size <= 0)
+        return;
+    m_pool = new TrackResidencyPool(
+        (unsigned)ServerConfig::m_track_residency_pool_size);
+}   // create
+
+// ----------------------------------------------------------------------------
+/** Releases all resident meshes, must be called before the irrlicht driver
+ *  is deleted. */
+void TrackResidencyPool::destroy()
+{
+    delete m_pool;
+    m_pool = NULL;
+}   // destroy
+
+// ----------------------------------------------------------------------------
+TrackResidencyPool::~TrackResidencyPool()
+{
+    for (Entry& entry : m_entries)
+        releaseMeshes(&entry);
+}   // ~TrackResidencyPool
+
+// ----------------------------------------------------------------------------
+TrackResidencyPool::Entry* TrackResidencyPool::findEntry(
+                                                     const std::string& ident)
+{
+    for (Entry& entry : m_entries)
+    {
+        if (entry.m_ident == ident)
+            return &entry;
+    }
+    return NULL;
+}   // findEntry
+
+// ----------------------------------------------------------------------------
+TrackResidencyPool::Entry* TrackResidencyPool::getOrCreateEntry(
+                                                     const std::string& ident)
+{
+    Entry* entry = findEntry(ident);
+    if (!entry)
+    {
+        m_entries.emplace_back();
+        entry = &m_entries.back();
+        entry->m_ident = ident;
+    }
+    entry->m_last_used = ++m_use_counter;
+    return entry;
+}   // getOrCreateEntry
+
+// ----------------------------------------------------------------------------
+/** Grabs all meshes (and their textures) which are still in irrlicht's mesh
+ *  cache and not yet in the entry. Meshes not in the cache (e.g. merged
+ *  ones) can't be found again when the track is loaded, so they are not
+ *  kept.
+ */
+void TrackResidencyPool::addMeshes(Entry* entry,
+                                   const std::vector<scene::IMesh*>& meshes)
+{
+    scene::IMeshCache* cache = irr_driver->getSceneManager()->getMeshCache();
+    for (scene::IMesh* mesh : meshes)
+    {
+        if (std::find(entry->m_meshes.begin(), entry->m_meshes.end(), mesh) !=
+            entry->m_meshes.end())
+            continue;
+        int index = cache->getMeshIndex(mesh);
+        if (index == -1 || (scene::IMesh*)cache->getMeshByIndex(index) != mesh)
+            continue;
+        mesh->grab();
+        irr_driver->grabAllTextures(mesh);
+        entry->m_meshes.push_back(mesh);
+    }
+}   // addMeshes
+
+// ----------------------------------------------------------------------------
+/** Drops the references of an entry, and removes meshes which are not used
+ *  anymore from irrlicht's cache (the same way Track::cleanup does it).
+ */
+void TrackResidencyPool::releaseMeshes(Entry* entry)
+{
+    for (scene::IMesh* mesh : entry->m_meshes)
+    {
+        irr_driver->dropAllTextures(mesh);
+        mesh->drop();
+        if (mesh->getReferenceCount() == 1)
+            irr_driver->removeMeshFromCache(mesh);
+    }
+    entry->m_meshes.clear();
+}   // releaseMeshes
+
+// ----------------------------------------------------------------------------
+/** Removes the least recently used tracks till the pool size is not
+ *  exceeded anymore.
+ *  \param keep_ident Track which must not be removed.
+ */
+void TrackResidencyPool::evict(const std::string& keep_ident)
+{
+    while (m_entries.size() > m_max_tracks)
+    {
+        auto lru = m_entries.end();
+        for (auto it = m_entries.begin(); it != m_entries.end(); it++)
+        {
+            if (it->m_ident == keep_ident)
+                continue;
+            if (lru == m_entries.end() || it->m_last_used < lru->m_last_used)
+                lru = it;
+        }
+        if (lru == m_entries.end())
+            return;
+        Log::debug("TrackResidencyPool", "Removing track %s.",
+                   lru->m_ident.c_str());
+        releaseMeshes(&*lru);
+        m_entries.erase(lru);
+    }
+}   // evict
+
+// ----------------------------------------------------------------------------
+bool TrackResidencyPool::isResident(const std::string& ident)
+{
+    return findEntry(ident) != NULL;
+}   // isResident
+
+// ----------------------------------------------------------------------------
+/** Called by Track::cleanup before the meshes of the track are dropped, the
+ *  meshes are then kept in irrlicht's cache for the next time this track is
+ *  used.
+ *  \param track The track which is being cleaned up.
+ *  \param meshes All cached meshes used by the track.
+ */
+void TrackResidencyPool::retain(const Track* track,
+                                const std::vector<scene::IMesh*>& meshes)
+{
+    Entry* entry = getOrCreateEntry(track->getIdent());
+    addMeshes(entry, meshes);
+    evict(track->getIdent());
+}   // retain
+
+// ----------------------------------------------------------------------------
+/** Loads the main model and static objects of a track into irrlicht's cache
+ *  without loading the track itself. Must be called from the main thread
+ *  while no track is loaded, e.g. when players are still voting.
+ *  \param track The track to load the models of.
+ */
+void TrackResidencyPool::preload(const Track* track)
+{
+    if (isResident(track->getIdent()))
+    {
+        findEntry(track->getIdent())->m_last_used = ++m_use_counter;
+        return;
+    }
+
+    // Use the same path as Track::loadMainTrack, so the file name in the
+    // mesh cache matches.
+    const std::string root = StringUtils::getPath(track->getFilename()) + "/";
+    XMLNode* xml = file_manager->createXMLTree(root + "scene.xml");
+    if (!xml)
+        return;
+    const XMLNode* track_node = xml->getNode("track");
+    if (!track_node)
+    {
+        delete xml;
+        return;
+    }
+
+    std::vector<std::string> models;
+    std::string model_name;
+    if (track_node->get("model", &model_name))
+        models.push_back(model_name);
+    for (unsigned int i = 0; i < track_node->getNumNodes(); i++)
+    {
+        const XMLNode* n = track_node->getNode(i);
+        if (n->getName() != "static-object")
+            continue;
+        model_name = "";
+        if (n->get("model", &model_name) && !model_name.empty())
+            models.push_back(model_name);
+    }
+    delete xml;
+
+    std::string unique_id =
+        StringUtils::insertValues("tracks/%s", track->getIdent().c_str());
+    file_manager->pushTextureSearchPath(root, unique_id);
+    file_manager->pushModelSearchPath(root);
+
+    std::vector<scene::IMesh*> meshes;
+    for (const std::string& model : models)
+    {
+        std::string full_path = root + model;
+        if (!file_manager->fileExists(full_path))
+            continue;
+        scene::IMesh* mesh = irr_driver->getMesh(full_path);
+        if (mesh)
+            meshes.push_back(mesh);
+    }
+
+    file_manager->popModelSearchPath();
+    file_manager->popTextureSearchPath();
+
+    Entry* entry = getOrCreateEntry(track->getIdent());
+    addMeshes(entry, meshes);
+    Log::info("TrackResidencyPool", "Preloaded %d models of track %s.",
+              (int)entry->m_meshes.size(), track->getIdent().c_str());
+    evict(track->getIdent());
+}   // preload
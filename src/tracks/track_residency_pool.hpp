@@ -0,0 +1,101 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_TRACK_RESIDENCY_POOL_HPP
+#define HEADER_TRACK_RESIDENCY_POOL_HPP
+
+#include "utils/no_copy.hpp"
+#include "utils/types.hpp"
+
+#include <string>
+#include <vector>
+
+namespace irr
+{
+    namespace scene { class IMesh; }
+}
+using namespace irr;
+
+class Track;
+
+/**
+  * \ingroup tracks
+  * Keeps the meshes of the most recently used tracks in irrlicht's mesh cache
+  * for servers without graphics, so loading the same track again (or a track
+  * preloaded while players are voting) doesn't need to read and parse the
+  * model files again. Only used without graphics, where the meshes don't keep
+  * pointers to the (temporary) materials of a track: these are looked up
+  * again by texture name when the track is converted to bullet. The pool is
+  * disabled (NULL) if track-residency-pool-size is 0 in server config.
+  */
+class TrackResidencyPool : public NoCopy
+{
+private:
+    struct Entry
+    {
+        std::string m_ident;
+        std::vector<scene::IMesh*> m_meshes;
+        uint64_t m_last_used;
+    };
+
+    static TrackResidencyPool* m_pool;
+
+    std::vector<Entry> m_entries;
+
+    unsigned m_max_tracks;
+
+    /** Increased each time a track is used, to find the least recently
+     *  used one. */
+    uint64_t m_use_counter;
+
+    // ------------------------------------------------------------------------
+    TrackResidencyPool(unsigned max_tracks)
+                      : m_max_tracks(max_tracks), m_use_counter(0) {}
+    // ------------------------------------------------------------------------
+    ~TrackResidencyPool();
+    // ------------------------------------------------------------------------
+    Entry* findEntry(const std::string& ident);
+    // ------------------------------------------------------------------------
+    Entry* getOrCreateEntry(const std::string& ident);
+    // ------------------------------------------------------------------------
+    static void addMeshes(Entry* entry,
+                          const std::vector<scene::IMesh*>& meshes);
+    // ------------------------------------------------------------------------
+    static void releaseMeshes(Entry* entry);
+    // ------------------------------------------------------------------------
+    void evict(const std::string& keep_ident);
+
+public:
+    // ------------------------------------------------------------------------
+    /** Returns the pool, or NULL if it's not used. */
+    static TrackResidencyPool* get()                         { return m_pool; }
+    // ------------------------------------------------------------------------
+    static void create();
+    // ------------------------------------------------------------------------
+    static void destroy();
+    // ------------------------------------------------------------------------
+    bool isResident(const std::string& ident);
+    // ------------------------------------------------------------------------
+    void retain(const Track* track,
+                const std::vector<scene::IMesh*>& meshes);
+    // ------------------------------------------------------------------------
+    void preload(const Track* track);
+
+};   // TrackResidencyPool
+
+#endif
@@ -122,18 +122,28 @@ void TrackSector::update(const Vec3 &xyz, bool ignore_vertical)
 
     // Now determine the 'track' coords, i.e. ow far from the start of the
     // track, and how far to the left or right of the center driveline.
-    DriveGraph::get()->spatialToTrack(&m_current_track_coords, xyz,
-        m_current_graph_node);
+    // Usually the valid nodes are the current node, in which case the
+    // coordinates don't need to be computed again.
+    const DriveGraph* dg = DriveGraph::get();
+    dg->spatialToTrack(&m_current_track_coords, xyz, m_current_graph_node);
 
-    if (m_last_valid_graph_node != Graph::UNKNOWN_SECTOR)
+    if (m_last_valid_graph_node == m_current_graph_node)
+    {
+        m_latest_valid_track_coords = m_current_track_coords;
+    }
+    else if (m_last_valid_graph_node != Graph::UNKNOWN_SECTOR)
     {
-        DriveGraph::get()->spatialToTrack(&m_latest_valid_track_coords, xyz,
+        dg->spatialToTrack(&m_latest_valid_track_coords, xyz,
             m_last_valid_graph_node);
     }
 
-    if (m_estimated_valid_graph_node != Graph::UNKNOWN_SECTOR)
+    if (m_estimated_valid_graph_node == m_current_graph_node)
+    {
+        m_estimated_valid_track_coords = m_current_track_coords;
+    }
+    else if (m_estimated_valid_graph_node != Graph::UNKNOWN_SECTOR)
     {
-        DriveGraph::get()->spatialToTrack(&m_estimated_valid_track_coords, xyz,
+        dg->spatialToTrack(&m_estimated_valid_track_coords, xyz,
             m_estimated_valid_graph_node);
     }
 }   // update
@@ -0,0 +1,20 @@
+#!/bin/bash
+# Compares the average physics step time of the bullet broadphases on some
+# standard tracks, the soccer field and a battle arena.
+# Usage: broadphase_benchmark.sh path/to/supertuxkart
+
+for broadphase in axis-sweep axis-sweep-32 dbvt; do
+    for track in cocoa_temple hacienda lighthouse snowmountain zengarden; do
+        echo -n "$broadphase $track: "
+        $1 --log=0 -R --broadphase=$broadphase \
+            --aiNP=nolok,nolok,nolok,nolok,nolok,nolok,nolok,nolok \
+            --track=$track --difficulty=3 --profile-laps=2 --no-graphics \
+            | grep "Average physics step"
+    done
+    echo -n "$broadphase soccer_field: "
+    $1 --log=0 --broadphase=$broadphase --soccer-ai-stats --no-graphics \
+        | grep "Average physics step"
+    echo -n "$broadphase temple: "
+    $1 --log=0 --broadphase=$broadphase --battle-ai-stats --no-graphics \
+        | grep "Average physics step"
+done